@@ -22,7 +22,10 @@ set_option_if_not_set(TYPECHECK_ENABLE_CPP_CHECK "Use cppcheck - ${in_source_msg
 set_option_if_not_set(TYPECHECK_WERROR "Use Werror" OFF)
 set_option_if_not_set(TYPECHECK_BUILD_TESTS "Build tests - ${in_source_msg}" ${default_if_in_dir})
 set_option_if_not_set(TYPECHECK_ENABLE_COVERAGE "Build code coverage targets, default OFF" OFF)
+set_option_if_not_set(TYPECHECK_ENABLE_PROFILER "Time each constraint during solve, see TypeManager::getProfile, default OFF" OFF)
+set_option_if_not_set(TYPECHECK_ENABLE_TRACING "Record trace spans of each solve phase, see TraceLog::flush, default OFF" OFF)
 set_option_if_not_set(TYPECHECK_ENABLE_BLOATY "Build bloaty target (unfinished, WIP)" OFF)
 
-set_option_if_not_set(TYPECHECK_PRINT_DEBUG_CONSTRAINTS "Prints debug information when creating constraints" OFF)
-set_option_if_not_set(TYPECHECK_PRINT_SHORT_DEBUG "Prints shorter debug description information, only active if TYPECHECK_PRINT_DEBUG_CONSTRAINTS=ON" ON)
+set_option_if_not_set(TYPECHECK_BUILD_TOOLS "Build the command line tools, such as typecheck_decode_log - ${in_source_msg}" ${default_if_in_dir})
+
+set_option_if_not_set(TYPECHECK_PRINT_DEBUG_CONSTRAINTS "Logs every constraint created to the DebugLog" OFF)
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "overload_table.hpp"
+#include "solver_observer.hpp"
+
+#include <algorithm>  // for all_of
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace typecheck {
+	// Satisfiability search over integer domains using conflict-directed backjumping.
+	// When every value of a variable fails, the variables responsible are recorded as a nogood,
+	// and the search jumps straight back to the most recent one, instead of the previous level.
+	class BackjumpSolver {
+	public:
+		using VarIndex = std::size_t;
+		using ValueID = std::size_t;
+		using ConstraintID = long long;
+
+		enum Result {
+			Satisfiable = 0,
+			Unsatisfiable,
+			// The node limit was reached before an answer was found.
+			Unknown,
+		};
+
+		class Assignment {
+		public:
+			bool isAssigned(const VarIndex var) const;
+			ValueID at(const VarIndex var) const;
+
+		private:
+			friend class BackjumpSolver;
+			std::vector<ValueID> values;
+			std::vector<bool> assigned;
+		};
+
+		using Predicate = std::function<bool(const Assignment&)>;
+
+		struct Stats {
+			std::size_t nodes = 0;
+			std::size_t backjumps = 0;
+			std::size_t nogoods = 0;
+		};
+
+		BackjumpSolver() = default;
+		~BackjumpSolver() = default;
+
+		VarIndex addVariable(std::vector<ValueID> domain);
+
+		// The predicate is only evaluated once every variable in the scope is assigned.
+		void addConstraint(const ConstraintID id, std::vector<VarIndex> scope, Predicate predicate);
+
+		// Checked once its whole scope is assigned like any other constraint, but also narrows the domains before searching.
+		void addTable(const ConstraintID id, OverloadTable table);
+
+		void setNodeLimit(const std::size_t limit);
+
+		Result solve();
+
+		// Same as `solve`, reporting every step of the search to the observer (see solver_observer.hpp).
+		template<typename Observer>
+		Result search(Observer& observer);
+
+		// Solves with each variable in `assumptions` fixed to its value, leaving the problem as it was for later solves.
+		Result solve(const std::vector<std::pair<VarIndex, ValueID>>& assumptions);
+
+		// Same as `solve` with assumptions, reporting to the observer.
+		template<typename Observer>
+		Result search(const std::vector<std::pair<VarIndex, ValueID>>& assumptions, Observer& observer);
+
+		// Only valid after `solve()` returned `Satisfiable`.
+		ValueID value(const VarIndex var) const;
+
+		// Constraints involved in the final conflict, only set after `solve()` returned `Unsatisfiable`.
+		const std::vector<ConstraintID>& conflict() const;
+
+		const Stats& stats() const;
+
+	private:
+		struct Rule {
+			ConstraintID id;
+			std::vector<VarIndex> scope;
+			Predicate predicate;
+		};
+
+		struct Nogood {
+			std::vector<std::pair<VarIndex, ValueID>> literals;
+			std::vector<ConstraintID> reasons;
+		};
+
+		bool filterUnary();
+		bool propagateTables();
+		void order();
+		void learn(const std::set<std::size_t>& conflictLevels, const std::set<ConstraintID>& reasons);
+
+		std::vector<std::vector<ValueID>> domains;
+		std::vector<Rule> rules;
+		std::vector<std::pair<ConstraintID, std::shared_ptr<const OverloadTable>>> tables;
+		std::vector<Nogood> nogoods;
+
+		// Constraints pruned from a variable's domain before search, blamed in any conflict on that variable.
+		std::vector<std::vector<ConstraintID>> pruned;
+
+		// Static variable order, and the inverse (variable -> level).
+		std::vector<VarIndex> levelVar;
+		std::vector<std::size_t> varLevel;
+
+		// Rules & nogoods are checked at the deepest level in their scope.
+		std::vector<std::vector<std::size_t>> rulesAt;
+		std::vector<std::vector<std::size_t>> nogoodsAt;
+
+		Assignment assignment;
+		std::vector<ConstraintID> conflictReasons;
+		std::size_t nodeLimit = std::numeric_limits<std::size_t>::max();
+		Stats _stats;
+	};
+
+	template<typename Observer>
+	auto BackjumpSolver::search(Observer& observer) -> Result {
+		this->_stats = {};
+		this->nogoods.clear();
+		this->conflictReasons.clear();
+
+		if (!this->filterUnary() || !this->propagateTables()) {
+			return Unsatisfiable;
+		}
+		this->order();
+
+		const auto numLevels = this->levelVar.size();
+		std::vector<std::size_t> cursor(numLevels, 0);
+		std::vector<std::set<std::size_t>> conflictLevels(numLevels);
+		std::vector<std::set<ConstraintID>> conflictRules(numLevels);
+
+		std::size_t level = 0;
+		while (level < numLevels) {
+			const auto var = this->levelVar.at(level);
+			const auto& domain = this->domains.at(var);
+			auto& conflictSet = conflictLevels.at(level);
+			auto& reasons = conflictRules.at(level);
+
+			bool consistent = false;
+			while (!consistent && cursor.at(level) < domain.size()) {
+				if (++this->_stats.nodes > this->nodeLimit) {
+					return Unknown;
+				}
+
+				this->assignment.values.at(var) = domain.at(cursor.at(level)++);
+				this->assignment.assigned.at(var) = true;
+				observer.expand(level, var, this->assignment.values.at(var));
+				consistent = true;
+
+				for (const auto& r : this->rulesAt.at(level)) {
+					const auto& rule = this->rules.at(r);
+					if (!rule.predicate(this->assignment)) {
+						for (const auto& other : rule.scope) {
+							if (this->varLevel.at(other) != level) {
+								conflictSet.insert(this->varLevel.at(other));
+							}
+						}
+						reasons.insert(rule.id);
+						observer.fail(rule.id);
+						consistent = false;
+						break;
+					}
+				}
+
+				if (!consistent) {
+					continue;
+				}
+
+				for (const auto& n : this->nogoodsAt.at(level)) {
+					const auto& nogood = this->nogoods.at(n);
+					const auto matches = std::all_of(nogood.literals.begin(), nogood.literals.end(), [this](const std::pair<VarIndex, ValueID>& literal) {
+						return this->assignment.at(literal.first) == literal.second;
+					});
+
+					if (matches) {
+						for (const auto& literal : nogood.literals) {
+							if (this->varLevel.at(literal.first) != level) {
+								conflictSet.insert(this->varLevel.at(literal.first));
+							}
+						}
+						reasons.insert(nogood.reasons.begin(), nogood.reasons.end());
+						for (const auto& reason : nogood.reasons) {
+							observer.fail(reason);
+						}
+						consistent = false;
+						break;
+					}
+				}
+			}
+
+			if (consistent) {
+				++level;
+				if (level < numLevels) {
+					cursor.at(level) = 0;
+					conflictLevels.at(level).clear();
+					conflictRules.at(level).clear();
+				}
+				continue;
+			}
+
+			// Every value failed, blame the variables in the conflict set.
+			this->assignment.assigned.at(var) = false;
+			reasons.insert(this->pruned.at(var).begin(), this->pruned.at(var).end());
+			if (conflictSet.empty()) {
+				this->conflictReasons.assign(reasons.begin(), reasons.end());
+				return Unsatisfiable;
+			}
+
+			this->learn(conflictSet, reasons);
+
+			const auto target = *conflictSet.rbegin();
+			observer.backtrack(level, target);
+			if (target + 1 < level) {
+				++this->_stats.backjumps;
+			}
+
+			// Everything between the culprit and here is unrelated to the failure, throw it away.
+			for (auto l = target + 1; l < level; ++l) {
+				this->assignment.assigned.at(this->levelVar.at(l)) = false;
+			}
+
+			conflictSet.erase(target);
+			conflictLevels.at(target).insert(conflictSet.begin(), conflictSet.end());
+			conflictRules.at(target).insert(reasons.begin(), reasons.end());
+			level = target;
+		}
+
+		return Satisfiable;
+	}
+
+	template<typename Observer>
+	auto BackjumpSolver::search(const std::vector<std::pair<VarIndex, ValueID>>& assumptions, Observer& observer) -> Result {
+		const auto original = this->domains;
+		for (const auto& [var, value] : assumptions) {
+			auto& domain = this->domains.at(var);
+			const auto possible = std::find(domain.begin(), domain.end(), value) != domain.end();
+			domain.assign(possible ? 1 : 0, value);
+		}
+
+		const auto result = this->search(observer);
+		this->domains = original;
+		return result;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "constraint_pass.hpp"
+#include "solve_stats.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace typecheck {
+	class TypeManager;
+
+	// Solves many independent `TypeManager`s on a pool of worker threads.
+	// Each worker has its own queue, and steals from the others once it runs dry.
+	class BatchSolver {
+	public:
+		struct Result {
+			std::optional<ConstraintPass> solution;
+			SolveStats stats;
+
+			// Which worker ran the job, and how long it sat in a queue first.
+			std::size_t worker = 0;
+			std::chrono::nanoseconds queued{0};
+		};
+
+		// `concurrency` is the maximum number of jobs solved at once, 0 means one per hardware thread.
+		explicit BatchSolver(const std::size_t concurrency = 0);
+		~BatchSolver();
+
+		// Not moveable or copyable
+		BatchSolver(const BatchSolver&) = delete;
+		BatchSolver& operator=(const BatchSolver&) = delete;
+		BatchSolver(BatchSolver&&) = delete;
+		BatchSolver& operator=(BatchSolver&&) = delete;
+
+		std::size_t concurrency() const;
+
+		// Blocks until every manager is solved, results are in the same order as `managers`.
+		// Managers must stay alive, and must not be used elsewhere, until this returns.
+		std::vector<Result> solve(const std::vector<TypeManager*>& managers);
+
+	private:
+		using Task = std::function<void(const std::size_t worker)>;
+
+		struct Queue {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void push(const std::size_t worker, Task task);
+		bool pop(const std::size_t worker, Task* task);
+		bool steal(const std::size_t worker, Task* task);
+		void work(const std::size_t worker);
+
+		std::vector<std::unique_ptr<Queue>> queues;
+		std::vector<std::thread> workers;
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::atomic<std::size_t> queued{0};
+		bool stopping = false;
+	};
+}
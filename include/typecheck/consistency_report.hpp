@@ -0,0 +1,29 @@
+#pragma once
+
+#include "constraint.hpp"
+
+#include <string>
+#include <vector>
+
+namespace typecheck {
+	// Describes why a constraint system has no solution, so it can be reported without searching.
+	class ConsistencyReport {
+	public:
+		ConsistencyReport() = default;
+		~ConsistencyReport() = default;
+
+		bool consistent() const;
+
+		const std::vector<Constraint::IDType>& conflicting() const;
+		void add_conflicting(const Constraint::IDType id);
+
+		const std::string& reason() const;
+		void set_reason(const std::string& reason);
+
+		std::string ShortDebugString() const;
+
+	private:
+		std::vector<Constraint::IDType> _conflicting;
+		std::string _reason;
+	};
+}
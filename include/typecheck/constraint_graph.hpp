@@ -0,0 +1,66 @@
+#pragma once
+
+#include "constraint.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace typecheck {
+	// The hypergraph of a constraint system, each constraint joins the type variables it mentions.
+	// Meant for finding what makes a system slow to solve, so it is a snapshot rather than kept up to date.
+	class ConstraintGraph {
+	public:
+		struct Variable {
+			std::string symbol;
+
+			// Number of types the variable could still take before searching.
+			std::size_t domain = 0;
+
+			// Number of constraints that mention it.
+			std::size_t degree = 0;
+			std::size_t component = 0;
+		};
+
+		struct Node {
+			Constraint::IDType id = 0;
+			ConstraintKind kind = Bind;
+
+			// Indices into `variables`.
+			std::vector<std::size_t> variables;
+			std::size_t component = 0;
+
+			// How often the last solve evaluated it, only known with detailed stats.
+			std::optional<std::size_t> evaluations;
+		};
+
+		ConstraintGraph() = default;
+		~ConstraintGraph() = default;
+
+		const std::vector<Variable>& variables() const;
+		const std::vector<Node>& constraints() const;
+
+		// Number of connected components, variables that share no constraint are each their own.
+		std::size_t components() const;
+
+		// Returns the index of the variable, adding it if it's new.
+		// A variable added more than once keeps the smallest domain, each constraint can only narrow it.
+		std::size_t add_variable(const std::string& symbol, const std::size_t domain);
+		Node* add_constraint(const Constraint::IDType id, const ConstraintKind kind);
+
+		// Fills in the degrees and components, call once everything is added.
+		void finalize();
+
+		// Graphviz, variables are ellipses and constraints boxes.
+		std::string to_dot() const;
+		std::string to_json() const;
+
+	private:
+		std::vector<Variable> _variables;
+		std::vector<Node> _constraints;
+		std::size_t _components = 0;
+		std::unordered_map<std::string, std::size_t> index;
+	};
+}
@@ -17,6 +17,9 @@ namespace typecheck {
 		bool hasResolvedType(const TypeVar& var) const;
 		bool setResolvedType(const TypeVar& var, const Type& type);
 
+		// By type variable symbol.
+		const std::unordered_map<std::string, Type>& getResolvedTypes() const;
+
 	private:
         // The key must be string, because 'typeVar' not comparable.
         std::unordered_map<std::string, Type> resolvedTypes;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "constraint.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace typecheck {
+	// Where the search spent its time, per constraint.
+	// Only filled in by `TypeManager::solve` when built with `TYPECHECK_ENABLE_PROFILER`, so other builds pay nothing for it.
+	class ConstraintProfile {
+	public:
+		struct Entry {
+			Constraint::IDType id = 0;
+			std::size_t evaluations = 0;
+
+			// Evaluations that returned false.
+			std::size_t failures = 0;
+			std::chrono::nanoseconds time{0};
+		};
+
+		ConstraintProfile() = default;
+		~ConstraintProfile() = default;
+
+		// Stays valid until `clear`, so the counters can be updated without looking them up again.
+		Entry* entry(const Constraint::IDType id);
+
+		// The `n` constraints that took the longest, slowest first.
+		std::vector<Entry> top(const std::size_t n) const;
+
+		std::size_t size() const;
+		void clear();
+
+		// One line per constraint in `top(n)`.
+		std::string ShortDebugString(const std::size_t n) const;
+
+	private:
+		std::unordered_map<Constraint::IDType, Entry> entries;
+	};
+}
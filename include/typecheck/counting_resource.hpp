@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace typecheck {
+	// Passes every allocation on to `upstream`, keeping track of how many bytes are currently allocated through it.
+	// Not thread safe, same as the pools it is meant to sit under.
+	class CountingResource : public std::pmr::memory_resource {
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+		std::pmr::memory_resource* upstream() const noexcept;
+
+		std::size_t allocated() const noexcept;
+
+		// Most bytes allocated at any one time.
+		std::size_t peak() const noexcept;
+
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+		std::pmr::memory_resource* _upstream;
+		std::size_t _allocated = 0;
+		std::size_t _peak = 0;
+	};
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string_view>
+
+namespace typecheck {
+	class Constraint;
+
+	// Debug messages as fixed-size binary records, instead of lines of text on `std::cout`.
+	// Each thread appends to its own ring buffer without locking, so logging never blocks or interleaves between threads.
+	// A buffer holds 4096 records, 192 KB, and is freed by the first flush after its thread exits.
+	// `flush` writes out the records from every thread, and `decode` turns them into text, usually offline.
+	class DebugLog {
+	public:
+		enum class Event : std::uint8_t {
+			// A constraint was created, only with `TYPECHECK_PRINT_DEBUG_CONSTRAINTS`.
+			CreateConstraint,
+
+			// A variable could never take any type.
+			EmptyDomain,
+			UnsupportedLiteral,
+			MalformedConstraint,
+			UnknownConstraint,
+
+			// `ConstraintPass::getResolvedType` for a variable without a type.
+			UnresolvedType,
+		};
+
+		static constexpr std::size_t MAX_VARS = 3;
+		static constexpr std::int64_t NONE = -1;
+
+		struct Record {
+			Event event;
+
+			// `ConstraintKind` of the constraint, if any.
+			std::uint8_t kind;
+
+			// Thread that logged it, filled in by `flush`.
+			std::uint16_t thread;
+
+			// Total number of vars in the constraint, only the first `MAX_VARS` are kept.
+			std::uint32_t numVars;
+
+			std::int64_t constraint;
+
+			// Function or protocol the constraint refers to.
+			std::int64_t detail;
+
+			// Type var indices, `T3` is 3, `NONE` for unused slots.
+			std::int64_t vars[MAX_VARS];
+		};
+
+		static void record(const Record& record);
+
+		// Logs the kind, id, vars and function or protocol of the constraint.
+		static void record(Event event, const Constraint& constraint);
+
+		// Logs an event about a single type var.
+		static void record(Event event, std::string_view var);
+
+		// Index of a type var from its symbol, or `NONE` if it doesn't end in a number.
+		static auto varIndex(std::string_view symbol) -> std::int64_t;
+
+		// Writes every record logged since the last flush, from every thread.
+		// The format is a short header followed by the raw records, decode it on a machine of the same endianness.
+		static void flush(std::ostream& out);
+
+		// Writes one line per record written by `flush`, returns false if the input isn't a debug log.
+		static auto decode(std::istream& in, std::ostream& out) -> bool;
+
+		// Records lost to a full buffer, since the process started.
+		static std::size_t dropped();
+
+		// Buffers currently allocated, one per thread that has logged and wasn't flushed since it exited.
+		static std::size_t buffers();
+	};
+}
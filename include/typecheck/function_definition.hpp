@@ -13,8 +13,12 @@ namespace typecheck {
 		FunctionDefinition();
 		~FunctionDefinition() = default;
 
+		// Copies are deep, so the pointers from `add_args` and `mutable_returntype` only ever change this definition.
+		// Share types through a `TypeFactory` instead.
 		FunctionDefinition(const FunctionDefinition& other);
 		FunctionDefinition& operator=(const FunctionDefinition& other);
+		FunctionDefinition(FunctionDefinition&& other) noexcept = default;
+		FunctionDefinition& operator=(FunctionDefinition&& other) noexcept = default;
 
 		bool operator==(const FunctionDefinition& other) const noexcept;
 		bool operator!=(const FunctionDefinition& other) const noexcept;
@@ -29,7 +33,7 @@ namespace typecheck {
 		Type* mutable_returntype();
 		bool has_returntype() const;
 
-		std::string name() const;
+		const std::string& name() const noexcept;
         void set_name(const std::string& name);
 
 		long long id() const;
@@ -44,6 +48,6 @@ namespace typecheck {
 		mutable std::unique_ptr<Type> _returnType;
 
 		std::string _name;
-		long long _id;
+		long long _id = 0;
 	};
 }
@@ -7,12 +7,20 @@ namespace typecheck {
 	public:
         using value_type = long long;
 		GenericTypeGenerator() = default;
+		explicit GenericTypeGenerator(std::string prefix);
 		~GenericTypeGenerator() = default;
 
         std::string next();
         value_type next_id();
 
+        // Number of symbols handed out so far.
+        value_type count() const noexcept;
+
+        // Starts again from the first symbol, or from `next`.
+        void reset(const value_type next = 0);
+
     private:
         value_type curr_num = 0;
+        std::string _prefix = "T";
 	};
 }
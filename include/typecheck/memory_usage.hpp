@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace typecheck {
+	class Constraint;
+	class FunctionVar;
+	class Type;
+	class TypeVar;
+
+	// Bytes held by a `TypeManager`, see `TypeManager::memoryUsage`.
+	// Estimated from the sizes and capacities of its containers, so it leaves out the allocator's own overhead.
+	struct MemoryUsage {
+		// Types and conversions registered with this manager.
+		std::size_t registry = 0;
+		std::size_t constraints = 0;
+		std::size_t typeVars = 0;
+
+		// Function overloads, and the types bound to their variables.
+		std::size_t functions = 0;
+
+		// Scratch memory kept between solves.
+		std::size_t solverWorkspace = 0;
+
+		// Types built by solving, the last warm-start solution, conflict and stats.
+		std::size_t result = 0;
+
+		// State frozen by `fork` and the shared registry, which other managers hold as well. Not part of `total`.
+		std::size_t shared = 0;
+
+		std::size_t total() const {
+			return this->registry + this->constraints + this->typeVars + this->functions + this->solverWorkspace + this->result;
+		}
+	};
+
+	// Bytes a value owns on the heap, beyond `sizeof` itself.
+	namespace heap {
+		std::size_t bytes(const std::string& str);
+		std::size_t bytes(const TypeVar& var);
+		std::size_t bytes(const Type& type);
+		std::size_t bytes(const FunctionVar& func);
+		std::size_t bytes(const Constraint& constraint);
+
+		template<typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+		std::size_t bytes(const T& /* value */) {
+			return 0;
+		}
+
+		// Declared up front, so containers of containers find each other.
+		template<typename A, typename B>
+		std::size_t bytes(const std::pair<A, B>& pair);
+		template<typename T>
+		std::size_t bytes(const std::vector<T>& vec);
+		template<typename T>
+		std::size_t bytes(const std::deque<T>& deque);
+		template<typename K, typename V, typename C, typename A>
+		std::size_t bytes(const std::map<K, V, C, A>& map);
+		template<typename T, typename C, typename A>
+		std::size_t bytes(const std::set<T, C, A>& set);
+		template<typename K, typename V, typename H, typename E, typename A>
+		std::size_t bytes(const std::unordered_map<K, V, H, E, A>& map);
+		template<typename K, typename V, typename H, typename E, typename A>
+		std::size_t bytes(const std::unordered_multimap<K, V, H, E, A>& map);
+		template<typename T, typename H, typename E, typename A>
+		std::size_t bytes(const std::unordered_set<T, H, E, A>& set);
+
+		template<typename A, typename B>
+		std::size_t bytes(const std::pair<A, B>& pair) {
+			return bytes(pair.first) + bytes(pair.second);
+		}
+
+		template<typename T>
+		std::size_t bytes(const std::vector<T>& vec) {
+			auto total = vec.capacity() * sizeof(T);
+			for (const auto& value : vec) {
+				total += bytes(value);
+			}
+			return total;
+		}
+
+		template<typename T>
+		std::size_t bytes(const std::deque<T>& deque) {
+			auto total = deque.size() * sizeof(T);
+			for (const auto& value : deque) {
+				total += bytes(value);
+			}
+			return total;
+		}
+
+		// Node based containers, each node also holds a few pointers (and the hash, for unordered ones).
+		template<typename Container>
+		std::size_t treeBytes(const Container& container) {
+			auto total = container.size() * (sizeof(typename Container::value_type) + 4 * sizeof(void*));
+			for (const auto& value : container) {
+				total += bytes(value);
+			}
+			return total;
+		}
+
+		template<typename Container>
+		std::size_t hashBytes(const Container& container) {
+			auto total = container.bucket_count() * sizeof(void*) + container.size() * (sizeof(typename Container::value_type) + 2 * sizeof(void*));
+			for (const auto& value : container) {
+				total += bytes(value);
+			}
+			return total;
+		}
+
+		template<typename K, typename V, typename C, typename A>
+		std::size_t bytes(const std::map<K, V, C, A>& map) {
+			return treeBytes(map);
+		}
+
+		template<typename T, typename C, typename A>
+		std::size_t bytes(const std::set<T, C, A>& set) {
+			return treeBytes(set);
+		}
+
+		template<typename K, typename V, typename H, typename E, typename A>
+		std::size_t bytes(const std::unordered_map<K, V, H, E, A>& map) {
+			return hashBytes(map);
+		}
+
+		template<typename K, typename V, typename H, typename E, typename A>
+		std::size_t bytes(const std::unordered_multimap<K, V, H, E, A>& map) {
+			return hashBytes(map);
+		}
+
+		template<typename T, typename H, typename E, typename A>
+		std::size_t bytes(const std::unordered_set<T, H, E, A>& set) {
+			return hashBytes(set);
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace typecheck {
+	// Every overload a call could bind to, as a single constraint over the call's variables.
+	// Choosing the row of an overload for the call's type makes each of the call's variables equal to the same one of its definition.
+	class OverloadTable {
+	public:
+		using VarIndex = std::size_t;
+		using ValueID = std::size_t;
+
+		struct Row {
+			ValueID function;
+			std::vector<VarIndex> definition;
+		};
+
+		OverloadTable(const VarIndex typeVar, std::vector<VarIndex> callVars);
+		~OverloadTable() = default;
+
+		// Overloads with the same value are the same function, so only the first is kept.
+		void add_row(const ValueID function, std::vector<VarIndex> definition);
+
+		const std::vector<Row>& rows() const;
+
+		// The type, the call, then the definition of each row, without repeats.
+		std::vector<VarIndex> scope() const;
+
+		// Generalised arc consistency, removes every value no remaining row supports.
+		// Adds the variables it narrowed to `narrowed`, returns false once one has nothing left.
+		bool propagate(std::vector<std::vector<ValueID>>& domains, std::vector<VarIndex>* narrowed) const;
+
+		template<typename Lookup>
+		bool satisfied(const Lookup& at) const {
+			const auto function = at(this->type);
+			for (const auto& row : this->_rows) {
+				if (row.function != function) {
+					continue;
+				}
+
+				if (row.definition.size() != this->call.size()) {
+					return false;
+				}
+				for (std::size_t i = 0; i < this->call.size(); ++i) {
+					if (at(this->call.at(i)) != at(row.definition.at(i))) {
+						return false;
+					}
+				}
+				return true;
+			}
+			return false;
+		}
+
+	private:
+		VarIndex type;
+		std::vector<VarIndex> call;
+		std::vector<Row> _rows;
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace typecheck {
 	class RawType {
@@ -13,7 +14,11 @@ namespace typecheck {
 		bool operator==(const RawType& other) const noexcept;
 		bool operator!=(const RawType& other) const noexcept;
 
-		std::string name() const;
+		// Compare against a name without building a `RawType`.
+		bool operator==(std::string_view name) const noexcept;
+		bool operator!=(std::string_view name) const noexcept;
+
+		const std::string& name() const noexcept;
 		void set_name(const std::string& name);
 
 		std::string ShortDebugString() const;
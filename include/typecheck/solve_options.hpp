@@ -0,0 +1,26 @@
+#pragma once
+
+#include "type.hpp"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+namespace typecheck {
+	// Changes how `TypeManager::solve` goes about solving, never what counts as a solution.
+	struct SolveOptions {
+		// Systems simple enough are solved without searching, turn this off to always search (to compare the two, for example).
+		bool fastPaths = true;
+
+		// Types to try first, by type variable symbol, usually from solving a similar system before.
+		// Only breaks ties between equally good solutions, and only for raw types.
+		std::unordered_map<std::string, Type> hints;
+
+		// Hints every variable with its type from the last solve made with `warmStart`, for re-checking after small edits.
+		// `hints` takes precedence over the last solution.
+		bool warmStart = false;
+
+		// Nodes the satisfiability search may visit before leaving the system to the optimizing search.
+		std::size_t nodeLimit = 100000;
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "constraint.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <unordered_map>
+
+namespace typecheck {
+	// Filled in by `TypeManager::solve`, describes the work done for the last solve.
+	struct SolveStats {
+		// How the last solve found its answer.
+		enum Path {
+			// The general, optimizing search.
+			Search = 0,
+
+			// Union-find over the equalities, for systems without conversions or a choice of overload.
+			Unification,
+
+			// Propagation along conversions, for systems without a choice of overload.
+			Lattice,
+
+			// Every literal given its preferred type where possible, without needing to search for a better one.
+			Defaulted,
+		};
+
+		std::size_t constraints = 0;
+		std::size_t variables = 0;
+
+		// Duplicate and trivially true constraints, removed before solving.
+		std::size_t simplified = 0;
+
+		// Overloads ruled out for a call before solving, by their number of args or the types already bound.
+		std::size_t prunedOverloads = 0;
+		bool solved = false;
+		Path path = Search;
+		std::chrono::nanoseconds duration{0};
+
+		// Times each constraint was evaluated, only filled in with `TypeManager::setDetailedStats`.
+		std::unordered_map<Constraint::IDType, std::size_t> evaluations;
+	};
+}
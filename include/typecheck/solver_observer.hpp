@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <unordered_map>
+
+namespace typecheck {
+	// Observers of `BackjumpSolver::search`, passed as a template policy instead of through virtual calls,
+	// so the search is compiled for each one and the default costs nothing at all.
+	// Every observer has these members, called as the search goes:
+	//  - expand(level, var, value): a value is tried for the variable at that level.
+	//  - fail(constraint): the constraint rejected the value just tried.
+	//    A learned nogood that rejects it reports each constraint it was learned from instead.
+	//  - backtrack(from, to): every value at `from` failed, the search goes back to `to`.
+	struct NullObserver {
+		void expand(std::size_t /* level */, std::size_t /* var */, std::size_t /* value */) {}
+		void fail(long long /* constraint */) {}
+		void backtrack(std::size_t /* from */, std::size_t /* to */) {}
+	};
+
+	struct CountingObserver {
+		std::size_t expansions = 0;
+		std::size_t failures = 0;
+		std::size_t backtracks = 0;
+
+		// Backtracks over more than one level.
+		std::size_t backjumps = 0;
+		std::unordered_map<long long, std::size_t> failuresByConstraint;
+
+		void expand(std::size_t /* level */, std::size_t /* var */, std::size_t /* value */) {
+			++this->expansions;
+		}
+
+		void fail(const long long constraint) {
+			++this->failures;
+			++this->failuresByConstraint[constraint];
+		}
+
+		void backtrack(const std::size_t from, const std::size_t to) {
+			++this->backtracks;
+			if (to + 1 < from) {
+				++this->backjumps;
+			}
+		}
+	};
+
+	// Any of the observers above behind plain function pointers, for code that isn't a template, like `TypeManager::solve`.
+	// Only refers to the observer, which has to outlive it.
+	class ObserverRef {
+	public:
+		template<typename Observer>
+		explicit ObserverRef(Observer& observer)
+			: target(&observer),
+			  onExpand([](void* o, const std::size_t level, const std::size_t var, const std::size_t value) {
+				  static_cast<Observer*>(o)->expand(level, var, value);
+			  }),
+			  onFail([](void* o, const long long constraint) {
+				  static_cast<Observer*>(o)->fail(constraint);
+			  }),
+			  onBacktrack([](void* o, const std::size_t from, const std::size_t to) {
+				  static_cast<Observer*>(o)->backtrack(from, to);
+			  }) {}
+
+		void expand(const std::size_t level, const std::size_t var, const std::size_t value) {
+			this->onExpand(this->target, level, var, value);
+		}
+
+		void fail(const long long constraint) {
+			this->onFail(this->target, constraint);
+		}
+
+		void backtrack(const std::size_t from, const std::size_t to) {
+			this->onBacktrack(this->target, from, to);
+		}
+
+	private:
+		void* target;
+		void (*onExpand)(void*, std::size_t, std::size_t, std::size_t);
+		void (*onFail)(void*, long long);
+		void (*onBacktrack)(void*, std::size_t, std::size_t);
+	};
+
+	// Writes one line per event, meant for a file opened by the caller.
+	class StreamObserver {
+	public:
+		explicit StreamObserver(std::ostream& stream) : out(stream) {}
+
+		void expand(const std::size_t level, const std::size_t var, const std::size_t value) {
+			this->out << "expand " << level << ' ' << var << ' ' << value << '\n';
+		}
+
+		void fail(const long long constraint) {
+			this->out << "fail " << constraint << '\n';
+		}
+
+		void backtrack(const std::size_t from, const std::size_t to) {
+			this->out << "backtrack " << from << ' ' << to << '\n';
+		}
+
+	private:
+		std::ostream& out;
+	};
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace typecheck {
+	// A fixed-size ring buffer for each thread, appended to without locking and drained from any thread.
+	// A full ring drops new entries until it is drained, `dropped` counts them.
+	// There is one set of rings per entry type for the whole process, so give each log its own entry type.
+	// Each thread that pushes holds `Size * sizeof(T)` bytes until it has exited and its ring has been drained.
+	template<typename T, std::size_t Size>
+	class ThreadRings {
+	public:
+		static void push(const T& entry) {
+			auto& ring = ThreadRings::local();
+			const auto head = ring.head.load(std::memory_order_relaxed);
+			if (head - ring.tail.load(std::memory_order_acquire) >= Size) {
+				ring.dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+
+			ring.entries.at(head % Size) = entry;
+			ring.head.store(head + 1, std::memory_order_release);
+		}
+
+		// Calls `f(thread, entry)` for everything pushed since the last drain, one thread at a time.
+		// Threads are numbered in the order they first pushed.
+		// Frees the rings of threads that have exited, once they are drained.
+		template<typename F>
+		static void drain(F&& f) {
+			auto& all = ThreadRings::all();
+			std::lock_guard<std::mutex> lock(all.mutex);
+			for (auto it = all.rings.begin(); it != all.rings.end();) {
+				const auto& ring = *it;
+
+				// Checked first, so everything an exited thread pushed is drained below.
+				const auto exited = ring->exited.load(std::memory_order_acquire);
+				const auto tail = ring->tail.load(std::memory_order_relaxed);
+				const auto head = ring->head.load(std::memory_order_acquire);
+				for (auto i = tail; i != head; ++i) {
+					f(ring->thread, ring->entries.at(i % Size));
+				}
+
+				// Hands the slots back to the thread.
+				ring->tail.store(head, std::memory_order_release);
+
+				if (exited) {
+					all.dropped += ring->dropped.load(std::memory_order_relaxed);
+					it = all.rings.erase(it);
+				} else {
+					++it;
+				}
+			}
+		}
+
+		static auto dropped() -> std::size_t {
+			auto& all = ThreadRings::all();
+			std::lock_guard<std::mutex> lock(all.mutex);
+			auto total = all.dropped;
+			for (const auto& ring : all.rings) {
+				total += ring->dropped.load(std::memory_order_relaxed);
+			}
+			return total;
+		}
+
+		// Rings still held, by threads that are running or haven't been drained since they exited.
+		static auto rings() -> std::size_t {
+			auto& all = ThreadRings::all();
+			std::lock_guard<std::mutex> lock(all.mutex);
+			return all.rings.size();
+		}
+
+	private:
+		// Written by its own thread only, and read by `drain`, so the indices are all the synchronization needed.
+		struct Ring {
+			std::array<T, Size> entries;
+			std::atomic<std::size_t> head{0};
+			std::atomic<std::size_t> tail{0};
+			std::atomic<std::size_t> dropped{0};
+			std::size_t thread = 0;
+
+			// Set once the thread has exited and will never push again.
+			std::atomic<bool> exited{false};
+		};
+
+		// Owned by the thread, marks its ring for `drain` to free on the way out.
+		struct Owner {
+			std::shared_ptr<Ring> ring;
+
+			~Owner() {
+				this->ring->exited.store(true, std::memory_order_release);
+			}
+		};
+
+		struct Rings {
+			// Only taken when a thread pushes its first entry, and to drain.
+			std::mutex mutex;
+
+			// Rings outlive their threads, so entries pushed just before a thread exits still get drained.
+			std::vector<std::shared_ptr<Ring>> rings;
+
+			// Entries dropped by rings that have since been freed.
+			std::size_t dropped = 0;
+
+			// Numbers threads even after their rings are freed.
+			std::size_t threads = 0;
+		};
+
+		static auto all() -> Rings& {
+			static Rings rings;
+			return rings;
+		}
+
+		static auto local() -> Ring& {
+			thread_local const Owner owner{[] {
+				auto& rings = ThreadRings::all();
+				auto created = std::make_shared<Ring>();
+				std::lock_guard<std::mutex> lock(rings.mutex);
+				created->thread = rings.threads++;
+				rings.rings.push_back(created);
+				return created;
+			}()};
+			return *owner.ring;
+		}
+	};
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace typecheck {
+	// Spans of time in the trace-event format, for chrome://tracing and Perfetto.
+	// Each thread records into its own ring buffer without locking, a full buffer drops new spans until the next flush.
+	// A buffer holds 8192 spans, 192 KB, and is freed by the first flush after its thread exits.
+	class TraceLog {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Span {
+			// Must outlive the flush, so always a string literal.
+			const char* name;
+
+			// Nanoseconds since the first span of the process.
+			std::int64_t begin;
+			std::int64_t duration;
+		};
+
+		static void record(const char* name, const Clock::time_point begin, const Clock::time_point end);
+
+		// Writes every span recorded since the last flush, from every thread, as trace-event JSON.
+		static void flush(std::ostream& out);
+
+		// Spans lost to a full buffer, since the process started.
+		static std::size_t dropped();
+
+		// Buffers currently allocated, one per thread that has recorded and wasn't flushed since it exited.
+		static std::size_t buffers();
+	};
+
+	// Records the time from construction to `end` (or destruction).
+	// Use the macros below instead, they compile it out with tracing off.
+	class TraceSpan {
+	public:
+		explicit TraceSpan(const char* spanName) : name(spanName), begin(TraceLog::Clock::now()) {}
+		~TraceSpan() {
+			this->end();
+		}
+
+		TraceSpan(const TraceSpan&) = delete;
+		TraceSpan& operator=(const TraceSpan&) = delete;
+
+		void end() {
+			if (!this->ended) {
+				TraceLog::record(this->name, this->begin, TraceLog::Clock::now());
+				this->ended = true;
+			}
+		}
+
+	private:
+		const char* name;
+		TraceLog::Clock::time_point begin;
+		bool ended = false;
+	};
+
+	// Adds up the time of many short steps of a phase, by kind, and records one span per kind at `end` (or destruction).
+	// A span for every step would fill the buffer on large systems, before the phases around it end and are recorded.
+	// The spans are laid end to end from the start, so their lengths are the totals but not when each step ran.
+	template<std::size_t Kinds>
+	class TraceTotals {
+	public:
+		TraceTotals() : begin(TraceLog::Clock::now()) {}
+		~TraceTotals() {
+			this->end();
+		}
+
+		TraceTotals(const TraceTotals&) = delete;
+		TraceTotals& operator=(const TraceTotals&) = delete;
+
+		// Times one step, until the end of its scope.
+		class Step {
+		public:
+			Step(TraceTotals& stepTotals, const std::size_t stepKind, const char* stepName) : totals(stepTotals), kind(stepKind), begin(TraceLog::Clock::now()) {
+				this->totals.names.at(this->kind) = stepName;
+			}
+			~Step() {
+				this->totals.durations.at(this->kind) += TraceLog::Clock::now() - this->begin;
+			}
+
+			Step(const Step&) = delete;
+			Step& operator=(const Step&) = delete;
+
+		private:
+			TraceTotals& totals;
+			std::size_t kind;
+			TraceLog::Clock::time_point begin;
+		};
+
+		void end() {
+			if (this->ended) {
+				return;
+			}
+
+			auto at = this->begin;
+			for (std::size_t kind = 0; kind < Kinds; ++kind) {
+				if (this->names.at(kind) != nullptr) {
+					TraceLog::record(this->names.at(kind), at, at + this->durations.at(kind));
+					at += this->durations.at(kind);
+				}
+			}
+			this->ended = true;
+		}
+
+	private:
+		TraceLog::Clock::time_point begin;
+		std::array<const char*, Kinds> names{};
+		std::array<TraceLog::Clock::duration, Kinds> durations{};
+		bool ended = false;
+	};
+}
+
+#ifdef TYPECHECK_ENABLE_TRACING
+#define TYPECHECK_TRACE_CONCAT_(a, b) a##b
+#define TYPECHECK_TRACE_CONCAT(a, b) TYPECHECK_TRACE_CONCAT_(a, b)
+
+// Until the end of the scope.
+#define TYPECHECK_TRACE_SPAN(name) typecheck::TraceSpan TYPECHECK_TRACE_CONCAT(_traceSpan, __LINE__)(name)
+
+// Until `TYPECHECK_TRACE_END(var)`, for a phase in the middle of a function.
+#define TYPECHECK_TRACE_BEGIN(var, name) typecheck::TraceSpan var(name)
+#define TYPECHECK_TRACE_END(var) var.end()
+
+// Totals for up to `kinds` kinds of step, recorded by `TYPECHECK_TRACE_END(var)`.
+#define TYPECHECK_TRACE_TOTALS(var, kinds) typecheck::TraceTotals<kinds> var
+// Adds the time until the end of the scope to `kind`, an index below `kinds`.
+#define TYPECHECK_TRACE_STEP(var, kind, name) decltype(var)::Step TYPECHECK_TRACE_CONCAT(_traceStep, __LINE__)(var, kind, name)
+#else
+#define TYPECHECK_TRACE_SPAN(name)
+#define TYPECHECK_TRACE_BEGIN(var, name)
+#define TYPECHECK_TRACE_END(var)
+#define TYPECHECK_TRACE_TOTALS(var, kinds)
+#define TYPECHECK_TRACE_STEP(var, kind, name)
+#endif
@@ -3,6 +3,8 @@
 #include "raw_type.hpp"
 #include "function_definition.hpp"
 
+#include <cstddef>
+#include <functional>
 #include <variant>
 
 namespace typecheck {
@@ -20,6 +22,9 @@ namespace typecheck {
 
 		bool operator==(const Type& other) const noexcept;
 
+		// Structural, equal types have equal hashes. Raw types hash the same as their name.
+		std::size_t hash() const noexcept;
+
 		Type& CopyFrom(const Type& other);
 
 		bool has_raw() const;
@@ -37,3 +42,12 @@ namespace typecheck {
 		mutable std::variant<bool, RawType, FunctionDefinition> data;
 	};
 }
+
+namespace std {
+	template<>
+	struct hash<typecheck::Type> {
+		std::size_t operator()(const typecheck::Type& type) const noexcept {
+			return type.hash();
+		}
+	};
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "type.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace typecheck {
+	// Builds each structurally distinct type once, and hands out references to the shared, immutable node.
+	// Two references are equal exactly when the types are, so comparing and hashing them is O(1).
+	class TypeFactory {
+	private:
+		struct Node;
+
+	public:
+		class Ref {
+		public:
+			Ref() = default;
+
+			bool operator==(const Ref& other) const noexcept;
+			bool operator!=(const Ref& other) const noexcept;
+			explicit operator bool() const noexcept;
+
+			bool is_function() const;
+			std::size_t hash() const noexcept;
+
+			// The node itself, copy it to change it.
+			const Type& type() const;
+
+		private:
+			friend class TypeFactory;
+			explicit Ref(const Node* node);
+
+			const Node* node = nullptr;
+		};
+
+		TypeFactory() = default;
+		~TypeFactory() = default;
+
+		// Refs point into the factory, so it can't be moved or copied.
+		TypeFactory(const TypeFactory&) = delete;
+		TypeFactory& operator=(const TypeFactory&) = delete;
+		TypeFactory(TypeFactory&&) = delete;
+		TypeFactory& operator=(TypeFactory&&) = delete;
+
+		Ref raw(std::string_view name);
+		Ref function(std::string_view name, const long long id, const std::vector<Ref>& args, const Ref& returnType);
+
+		// Returns an empty `Ref` for types that are neither raw nor functions.
+		Ref intern(const Type& type);
+
+		// Number of distinct types built so far.
+		std::size_t size() const noexcept;
+
+		// Estimated bytes held by the types built so far, see `MemoryUsage`.
+		std::size_t memoryUsage() const;
+
+		// Invalidates every `Ref` handed out.
+		void clear();
+
+	private:
+		struct Node {
+			Type type;
+			std::size_t hash = 0;
+
+			// Children, so functions can be matched without comparing them deeply.
+			std::vector<const Node*> args;
+			const Node* returnType = nullptr;
+		};
+
+		std::deque<Node> nodes;
+
+		// Keys point into the nodes they map to.
+		std::unordered_map<std::string_view, const Node*> raws;
+		std::unordered_multimap<std::size_t, const Node*> functions;
+	};
+}
+
+namespace std {
+	template<>
+	struct hash<typecheck::TypeFactory::Ref> {
+		std::size_t operator()(const typecheck::TypeFactory::Ref& ref) const noexcept {
+			return ref.hash();
+		}
+	};
+}
@@ -1,15 +1,29 @@
 #pragma once
 
+#include "backjump_solver.hpp"
 #include "constraint.hpp"
 #include "constraint_pass.hpp"
+#include "constraint_profile.hpp"
+#include "consistency_report.hpp"
+#include "constraint_graph.hpp"
+#include "counting_resource.hpp"
 #include "function_var.hpp"
 #include "generic_type_generator.hpp"
+#include "memory_usage.hpp"
+#include "solve_options.hpp"
+#include "solve_stats.hpp"
+#include "type_factory.hpp"
+#include "type_registry.hpp"
 
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <optional>
 
 namespace typecheck {
@@ -17,6 +31,7 @@ namespace typecheck {
 	class TypeManager {
 	public:
 		TypeManager();
+		explicit TypeManager(std::shared_ptr<const TypeRegistry> registry, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
 		~TypeManager() = default;
 
 		// Not moveable or copyable
@@ -28,6 +43,8 @@ namespace typecheck {
 		// 'Register' types
         bool registerType(const std::string& name);
 		bool registerType(const Type& name);
+		std::size_t registerTypes(const std::vector<std::string>& names);
+		std::size_t registerTypes(const std::vector<Type>& types);
         bool hasRegisteredType(const std::string& name) const noexcept;
 		bool hasRegisteredType(const Type& name) const noexcept;
         Type getRegisteredType(const std::string& name) const noexcept;
@@ -54,19 +71,144 @@ namespace typecheck {
 
         const Constraint* getConstraint(const Constraint::IDType id) const;
 
-		std::optional<ConstraintPass> solve();
+		// Finds common contradictions without searching, in near-linear time.
+		ConsistencyReport checkConsistency() const;
+
+		std::optional<ConstraintPass> solve(const SolveOptions& options = {});
+
+		// Same as `solve`, reporting every step of the backjumping search to the observer (see solver_observer.hpp).
+		// Solves taken by a fast path never search, so the observer hears nothing from them.
+		template<typename Observer>
+		std::optional<ConstraintPass> solve(const SolveOptions& options, Observer& observer) {
+			ObserverRef ref(observer);
+			return this->solveObserved(options, &ref);
+		}
+
+		// Starts a new manager from everything registered and constrained here so far, in O(1).
+		// That state is frozen and shared by both managers, anything added afterwards is only seen by the one it was added to.
+		// The child uses the same shared registry and upstream memory resource.
+		std::unique_ptr<TypeManager> fork();
+
+		// Clears the constraints, type variables and function overloads, keeping the memory already allocated.
+		// Leaves the manager as good as new, so one can be pooled per thread rather than created per function.
+		// Also lets go of any state shared through `fork`, other than its registered types if they're kept.
+		void reset(const bool keepRegisteredTypes = false);
+
+		// Why the last call to `solve` failed, if it was proven unsatisfiable.
+		const ConsistencyReport& getConflict() const;
+
+		// What the last call to `solve` did.
+		const SolveStats& getStats() const;
+
+		// Also counts how often `solve` evaluates each constraint, which slows the search down.
+		void setDetailedStats(const bool enabled);
+
+		// Estimated bytes held by this manager, by what they're for.
+		MemoryUsage memoryUsage() const;
+
+		// Every constraint and the variables it joins, with the evaluations from the last `solve` if detailed stats are on.
+		ConstraintGraph getConstraintGraph() const;
+
+#ifdef TYPECHECK_ENABLE_PROFILER
+		// Time spent in each constraint during the last `solve`, see `ConstraintProfile::top`.
+		const ConstraintProfile& getProfile() const;
+#endif
+
+		// Only the constraints added since the last `fork`.
 		std::vector<Constraint> constraints;
 
 	private:
-		std::vector<Type> registeredTypes;
-		std::set<std::string> registeredTypeVars;
-		std::map<std::string, std::set<std::string>> convertible;
-		std::vector<FunctionVar> functions;
+		// State frozen by `fork`, on top of the state from any earlier forks.
+		struct Frozen {
+			std::shared_ptr<const Frozen> parent;
+			TypeRegistry registry;
+			std::vector<Constraint> constraints;
+			std::unordered_set<std::string> typeVars;
+		};
+
+		// Read-only and shared with other managers, anything registered here goes into `registry`.
+		std::shared_ptr<const TypeRegistry> shared;
+		std::shared_ptr<const Frozen> frozen;
+		TypeRegistry registry;
+
+		// Shared registry first, then the frozen ones (oldest first), then `registry`.
+		std::vector<const TypeRegistry*> registryLayers;
+		const std::vector<const TypeRegistry*>& registries() const;
+		void updateRegistries();
+
+		// Frozen constraints first, in the order they were created.
+		std::pmr::vector<const Constraint*> allConstraints(std::pmr::memory_resource* resource) const;
+
+		// Unordered so `reset` keeps the buckets.
+		std::unordered_set<std::string> registeredTypeVars;
+		bool hasTypeVar(const std::string& symbol) const;
 
 		GenericTypeGenerator type_generator;
 		GenericTypeGenerator constraint_generator;
         std::vector<FunctionVar> getFunctionOverloads(const Constraint::IDType& funcID) const;
 
+        // `nullptr` if not registered, lookups by name only match raw types.
+        const Type* findRegisteredType(const Type& name) const noexcept;
+        const Type* findRegisteredType(std::string_view name) const noexcept;
+
+        // Drops duplicate constraints, and ones that always hold (`T == T`, `T` converts to `T`), keeping the first of each.
+        struct SimplifiedConstraints {
+            std::pmr::vector<const Constraint*> kept;
+            std::pmr::vector<const Constraint*> dropped;
+        };
+        SimplifiedConstraints simplifyConstraints(const std::pmr::vector<const Constraint*>& active, std::pmr::memory_resource* resource) const;
+
+        // The overloads each call (by constraint) could bind to, those with the same number of args and without an arg or return type bound to a different type.
+        // Found once per solve, so the later steps never consider an overload that can't match.
+        // Adds the number of overloads ruled out to `pruned`, if given.
+        using OverloadCandidates = std::pmr::unordered_map<Constraint::IDType, std::vector<FunctionVar>>;
+        OverloadCandidates findOverloadCandidates(const std::pmr::vector<const Constraint*>& active, std::pmr::memory_resource* resource, std::size_t* pruned = nullptr) const;
+
+        // Type each variable (by symbol) should try first, for warm starts.
+        using Hints = std::pmr::unordered_map<std::string_view, std::string_view>;
+        Hints collectHints(const SolveOptions& options, std::pmr::memory_resource* resource) const;
+
+        // Solves systems without a choice of overload in polynomial time, unifying equal variables and propagating along the conversions between registered types.
+        // Falls back when the system needs something it can't handle, or when it can't prove its answer is the one the search would find.
+        enum class FastPath {
+            Solved,
+            Unsatisfiable,
+            Fallback,
+        };
+        FastPath solveLattice(const std::pmr::vector<const Constraint*>& active, const std::pmr::vector<const Constraint*>& dropped, const OverloadCandidates& overloads, const Hints& hints, ConstraintPass* pass, std::pmr::memory_resource* resource);
+
+        // Cheap satisfiability search with conflict analysis, run before the optimizing search.
+        // Gives up after `nodeLimit` nodes of any one search, see `SolveOptions::nodeLimit`.
+        // With `defaulted`, also tries giving each literal its preferred type. If that provably gives the best solution, it's filled in with the value of every variable.
+        using Assignments = std::pmr::unordered_map<std::string, std::string>;
+        // Every search is reported to `observer`, if given.
+        BackjumpSolver::Result checkSatisfiable(const SimplifiedConstraints& system, const OverloadCandidates& overloads, const Hints& hints, ConsistencyReport* report, std::pmr::memory_resource* resource, std::size_t nodeLimit, ObserverRef* observer, Assignments* defaulted = nullptr) const;
+        ConsistencyReport checkConsistency(const std::pmr::vector<const Constraint*>& active, std::pmr::memory_resource* resource) const;
+
+        // Both `solve`s, the plain one without an observer.
+        std::optional<ConstraintPass> solveObserved(const SolveOptions& options, ObserverRef* observer);
+        std::optional<ConstraintPass> solveConstraints(const SolveOptions& options, ObserverRef* observer);
+
+        ConsistencyReport conflict;
+        SolveStats stats;
+
+        // Last solution found with `SolveOptions::warmStart`.
+        std::optional<ConstraintPass> lastSolution;
+        bool detailedStats = false;
+#ifdef TYPECHECK_ENABLE_PROFILER
+        ConstraintProfile profile;
+#endif
+
+        // Resolved types, shared between solves (and their solutions).
+        TypeFactory typeFactory;
+
+        // Scratch memory for a single solve, released all at once when it finishes.
+        // The pool keeps the released blocks, so later solves rarely go back to `upstream`.
+        // `workspace` counts what the pool holds, for `memoryUsage`.
+        CountingResource workspace;
+        std::pmr::unsynchronized_pool_resource pool;
+        std::pmr::monotonic_buffer_resource arena;
+
         // Internal helper
         Constraint* getConstraintInternal(const Constraint::IDType id);
 	};
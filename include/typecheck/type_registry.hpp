@@ -0,0 +1,102 @@
+#pragma once
+
+#include "constraint.hpp"
+#include "function_var.hpp"
+#include "generic_type_generator.hpp"
+#include "type.hpp"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace typecheck {
+	// Registered types, conversions and function overloads.
+	// Build one up, then share it read-only between any number of `TypeManager`s (and threads):
+	//     auto registry = std::make_shared<const TypeRegistry>(std::move(builder));
+	class TypeRegistry {
+	public:
+		TypeRegistry();
+		~TypeRegistry() = default;
+
+		TypeRegistry(const TypeRegistry&) = default;
+		TypeRegistry& operator=(const TypeRegistry&) = default;
+		TypeRegistry(TypeRegistry&&) = default;
+		TypeRegistry& operator=(TypeRegistry&&) = default;
+
+		// Shared by every `TypeManager` created without a registry.
+		static const std::shared_ptr<const TypeRegistry>& empty();
+
+		// Snapshot of everything registered, loading one is much faster than replaying the calls that built it.
+		// Only readable on machines with the same byte order, `nullopt` if the snapshot is malformed.
+		std::string serialize() const;
+		static std::optional<TypeRegistry> unserialize(std::string_view snapshot);
+
+		// Same as above, through a file. `load` maps the file read-only rather than copying it where it can.
+		bool save(const std::string& path) const;
+		static std::optional<TypeRegistry> load(const std::string& path);
+
+		bool registerType(const std::string& name);
+		bool registerType(const Type& type);
+
+		// Returns how many were new, faster than registering them one at a time.
+		std::size_t registerTypes(const std::vector<std::string>& names);
+		std::size_t registerTypes(const std::vector<Type>& types);
+
+		bool hasRegisteredType(const Type& type) const noexcept;
+		Type getRegisteredType(const Type& type) const noexcept;
+
+		// `nullptr` if not registered, lookups by name only match raw types.
+		const Type* findRegisteredType(const Type& type) const noexcept;
+		const Type* findRegisteredType(std::string_view name) const noexcept;
+
+		bool setConvertible(const std::string& T0, const std::string& T1);
+		bool setConvertible(const Type& T0, const Type& T1);
+
+		// Only looks at conversions added explicitly, by name.
+		bool hasConversion(const std::string& T0, const std::string& T1) const noexcept;
+		bool addConversion(const std::string& T0, const std::string& T1);
+
+		// Adds an overload with concrete types, which can be shared between managers.
+		Constraint::IDType addFunction(const Constraint::IDType& functionid, const std::vector<Type>& args, const Type& returnType);
+
+		// Adds an overload whose variables are constrained by the owning `TypeManager`.
+		void addFunction(const FunctionVar& func);
+
+		// Both keep the capacity already allocated, so the registry can be reused.
+		// `clearFunctions` keeps the registered types and conversions, `clear` removes everything.
+		void clearFunctions();
+		void clear();
+
+		const std::vector<Type>& types() const;
+		const std::map<std::string, std::set<std::string>>& conversions() const;
+		const std::vector<FunctionVar>& functions() const;
+
+		// Type of a variable created by `addFunction` with concrete types.
+		bool hasBoundType(const std::string& symbol) const;
+		const Type& getBoundType(const std::string& symbol) const;
+
+		// Estimated bytes held, see `MemoryUsage`.
+		// Types and conversions, then functions and the types bound to their variables.
+		std::size_t typesMemoryUsage() const;
+		std::size_t functionsMemoryUsage() const;
+
+	private:
+		void reserveTypes(const std::size_t count);
+
+		std::vector<Type> registeredTypes;
+
+		// `Type::hash` to positions in `registeredTypes`, raw types hash the same as their name.
+		std::unordered_multimap<std::size_t, std::size_t> typeIndex;
+		std::map<std::string, std::set<std::string>> convertible;
+		std::vector<FunctionVar> _functions;
+		std::map<std::string, Type> boundTypes;
+
+		// Distinct from the `TypeManager` symbols, so they never collide.
+		GenericTypeGenerator type_generator;
+	};
+}
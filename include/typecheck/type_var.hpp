@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace typecheck {
 	class TypeVar {
@@ -12,9 +13,13 @@ namespace typecheck {
 		bool operator!=(const TypeVar& other) const noexcept;
 		bool operator<(const TypeVar& other) const noexcept;
 
+		// Compare against a symbol without building a `TypeVar`.
+		bool operator==(std::string_view symbol) const noexcept;
+		bool operator!=(std::string_view symbol) const noexcept;
+
 		void CopyFrom(const TypeVar& other);
 
-		std::string symbol() const;
+		const std::string& symbol() const noexcept;
 		void set_symbol(const std::string& s);
 
 		std::string ShortDebugString() const;
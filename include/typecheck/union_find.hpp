@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace typecheck {
+	// Disjoint sets over dense indices, with path compression and union by size.
+	class UnionFind {
+	public:
+		using value_type = std::size_t;
+		UnionFind() = default;
+		~UnionFind() = default;
+
+		value_type add();
+		value_type find(const value_type i);
+
+		// Returns false if both were already in the same set.
+		bool unite(const value_type a, const value_type b);
+
+		std::size_t size() const;
+
+	private:
+		std::vector<value_type> parent;
+		std::vector<std::size_t> setSize;
+	};
+}
@@ -0,0 +1,194 @@
+#include "typecheck/backjump_solver.hpp"
+
+#include <algorithm>  // for sort, remove_if, find
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace typecheck;
+
+namespace {
+	// Learning every nogood is quadratic in the worst case, keep only the short (most general) ones.
+	constexpr std::size_t MAX_NOGOOD_SIZE = 8;
+	constexpr std::size_t MAX_NOGOODS = 1 << 16;
+}
+
+auto BackjumpSolver::Assignment::isAssigned(const VarIndex var) const -> bool {
+	return var < this->assigned.size() && this->assigned.at(var);
+}
+
+auto BackjumpSolver::Assignment::at(const VarIndex var) const -> ValueID {
+	return this->values.at(var);
+}
+
+auto BackjumpSolver::addVariable(std::vector<ValueID> domain) -> VarIndex {
+	this->domains.emplace_back(std::move(domain));
+	return this->domains.size() - 1;
+}
+
+void BackjumpSolver::addConstraint(const ConstraintID id, std::vector<VarIndex> scope, Predicate predicate) {
+	this->rules.push_back({id, std::move(scope), std::move(predicate)});
+}
+
+void BackjumpSolver::addTable(const ConstraintID id, OverloadTable table) {
+	auto shared = std::make_shared<const OverloadTable>(std::move(table));
+	this->addConstraint(id, shared->scope(), [shared](const Assignment& a) {
+		return shared->satisfied([&a](const VarIndex var) {
+			return a.at(var);
+		});
+	});
+	this->tables.emplace_back(id, std::move(shared));
+}
+
+void BackjumpSolver::setNodeLimit(const std::size_t limit) {
+	this->nodeLimit = limit;
+}
+
+auto BackjumpSolver::value(const VarIndex var) const -> ValueID {
+	return this->assignment.at(var);
+}
+
+auto BackjumpSolver::conflict() const -> const std::vector<ConstraintID>& {
+	return this->conflictReasons;
+}
+
+auto BackjumpSolver::stats() const -> const Stats& {
+	return this->_stats;
+}
+
+auto BackjumpSolver::filterUnary() -> bool {
+	// Unary constraints never take part in a branch, apply them to the domains up front.
+	this->pruned.assign(this->domains.size(), {});
+	this->assignment.values.assign(this->domains.size(), 0);
+	this->assignment.assigned.assign(this->domains.size(), false);
+
+	for (const auto& rule : this->rules) {
+		std::set<VarIndex> vars(rule.scope.begin(), rule.scope.end());
+		if (vars.size() != 1) {
+			continue;
+		}
+
+		const auto var = *vars.begin();
+		auto& domain = this->domains.at(var);
+		const auto before = domain.size();
+		this->assignment.assigned.at(var) = true;
+		domain.erase(std::remove_if(domain.begin(), domain.end(), [this, &rule, var](const ValueID val) {
+			this->assignment.values.at(var) = val;
+			return !rule.predicate(this->assignment);
+		}), domain.end());
+		this->assignment.assigned.at(var) = false;
+
+		if (domain.size() != before) {
+			this->pruned.at(var).push_back(rule.id);
+		}
+
+		if (domain.empty()) {
+			this->conflictReasons = this->pruned.at(var);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+auto BackjumpSolver::propagateTables() -> bool {
+	// Narrowing one table can take away the support of another, so repeat until nothing changes.
+	bool changed = !this->tables.empty();
+	while (changed) {
+		changed = false;
+		for (const auto& [id, table] : this->tables) {
+			std::vector<VarIndex> narrowed;
+			const auto consistent = table->propagate(this->domains, &narrowed);
+			for (const auto& var : narrowed) {
+				auto& reasons = this->pruned.at(var);
+				if (std::find(reasons.begin(), reasons.end(), id) == reasons.end()) {
+					reasons.push_back(id);
+				}
+				if (this->domains.at(var).empty()) {
+					this->conflictReasons = this->pruned.at(var);
+				}
+			}
+
+			if (!consistent) {
+				if (std::find(this->conflictReasons.begin(), this->conflictReasons.end(), id) == this->conflictReasons.end()) {
+					this->conflictReasons.push_back(id);
+				}
+				return false;
+			}
+			changed |= !narrowed.empty();
+		}
+	}
+
+	return true;
+}
+
+void BackjumpSolver::order() {
+	std::vector<std::size_t> degree(this->domains.size(), 0);
+	for (const auto& rule : this->rules) {
+		for (const auto& var : rule.scope) {
+			++degree.at(var);
+		}
+	}
+
+	// Smallest domain first, then the most constrained, so failures are found as early as possible.
+	this->levelVar.resize(this->domains.size());
+	for (std::size_t i = 0; i < this->levelVar.size(); ++i) {
+		this->levelVar.at(i) = i;
+	}
+	std::stable_sort(this->levelVar.begin(), this->levelVar.end(), [this, &degree](const VarIndex a, const VarIndex b) {
+		if (this->domains.at(a).size() != this->domains.at(b).size()) {
+			return this->domains.at(a).size() < this->domains.at(b).size();
+		}
+		return degree.at(a) > degree.at(b);
+	});
+
+	this->varLevel.assign(this->domains.size(), 0);
+	for (std::size_t level = 0; level < this->levelVar.size(); ++level) {
+		this->varLevel.at(this->levelVar.at(level)) = level;
+	}
+
+	this->rulesAt.assign(this->domains.size(), {});
+	this->nogoodsAt.assign(this->domains.size(), {});
+	for (std::size_t i = 0; i < this->rules.size(); ++i) {
+		const auto& scope = this->rules.at(i).scope;
+		if (std::set<VarIndex>(scope.begin(), scope.end()).size() < 2) {
+			// Already applied by `filterUnary`
+			continue;
+		}
+
+		std::size_t deepest = 0;
+		for (const auto& var : scope) {
+			deepest = std::max(deepest, this->varLevel.at(var));
+		}
+		this->rulesAt.at(deepest).push_back(i);
+	}
+}
+
+void BackjumpSolver::learn(const std::set<std::size_t>& conflictLevels, const std::set<ConstraintID>& reasons) {
+	if (conflictLevels.size() > MAX_NOGOOD_SIZE || this->nogoods.size() >= MAX_NOGOODS) {
+		return;
+	}
+
+	// The current values of the conflict set can never be extended to a solution.
+	Nogood nogood;
+	for (const auto& level : conflictLevels) {
+		const auto var = this->levelVar.at(level);
+		nogood.literals.emplace_back(var, this->assignment.at(var));
+	}
+	nogood.reasons.assign(reasons.begin(), reasons.end());
+
+	this->nogoodsAt.at(*conflictLevels.rbegin()).push_back(this->nogoods.size());
+	this->nogoods.emplace_back(std::move(nogood));
+	++this->_stats.nogoods;
+}
+
+auto BackjumpSolver::solve() -> Result {
+	NullObserver observer;
+	return this->search(observer);
+}
+
+auto BackjumpSolver::solve(const std::vector<std::pair<VarIndex, ValueID>>& assumptions) -> Result {
+	NullObserver observer;
+	return this->search(assumptions, observer);
+}
@@ -0,0 +1,136 @@
+#include <typecheck/batch_solver.hpp>
+#include <typecheck/type_manager.hpp>
+
+#include <algorithm>  // for max
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <utility>    // for move
+#include <vector>
+
+using namespace typecheck;
+
+BatchSolver::BatchSolver(const std::size_t concurrency) {
+	const auto numWorkers = std::max<std::size_t>(1, concurrency == 0 ? std::thread::hardware_concurrency() : concurrency);
+	for (std::size_t i = 0; i < numWorkers; ++i) {
+		this->queues.emplace_back(std::make_unique<Queue>());
+	}
+
+	// Only start the threads once every queue exists, they steal from each other.
+	for (std::size_t i = 0; i < numWorkers; ++i) {
+		this->workers.emplace_back([this, i] { this->work(i); });
+	}
+}
+
+BatchSolver::~BatchSolver() {
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+
+	for (auto& worker : this->workers) {
+		worker.join();
+	}
+}
+
+auto BatchSolver::concurrency() const -> std::size_t {
+	return this->workers.size();
+}
+
+void BatchSolver::push(const std::size_t worker, Task task) {
+	{
+		std::lock_guard<std::mutex> lock(this->queues.at(worker)->mutex);
+		this->queues.at(worker)->tasks.emplace_back(std::move(task));
+	}
+
+	// Count under the pool lock, so a worker about to sleep can't miss it.
+	std::lock_guard<std::mutex> lock(this->mutex);
+	++this->queued;
+}
+
+auto BatchSolver::pop(const std::size_t worker, Task* task) -> bool {
+	auto& queue = *this->queues.at(worker);
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.tasks.empty()) {
+		return false;
+	}
+
+	*task = std::move(queue.tasks.front());
+	queue.tasks.pop_front();
+	--this->queued;
+	return true;
+}
+
+auto BatchSolver::steal(const std::size_t worker, Task* task) -> bool {
+	for (std::size_t i = 1; i < this->queues.size(); ++i) {
+		auto& queue = *this->queues.at((worker + i) % this->queues.size());
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+
+		// Take from the opposite end to the owner, so the two rarely fight over the same job.
+		*task = std::move(queue.tasks.back());
+		queue.tasks.pop_back();
+		--this->queued;
+		return true;
+	}
+	return false;
+}
+
+void BatchSolver::work(const std::size_t worker) {
+	while (true) {
+		Task task;
+		if (this->pop(worker, &task) || this->steal(worker, &task)) {
+			task(worker);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		this->wake.wait(lock, [this] { return this->stopping || this->queued > 0; });
+		if (this->stopping && this->queued == 0) {
+			return;
+		}
+	}
+}
+
+auto BatchSolver::solve(const std::vector<TypeManager*>& managers) -> std::vector<Result> {
+	std::vector<Result> results(managers.size());
+	std::vector<std::exception_ptr> errors(managers.size());
+
+	std::mutex doneMutex;
+	std::condition_variable done;
+	std::size_t remaining = managers.size();
+
+	const auto submitted = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < managers.size(); ++i) {
+		this->push(i % this->queues.size(), [&, i](const std::size_t worker) {
+			auto& result = results.at(i);
+			result.worker = worker;
+			result.queued = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - submitted);
+			try {
+				result.solution = managers.at(i)->solve();
+				result.stats = managers.at(i)->getStats();
+			} catch (...) {
+				errors.at(i) = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(doneMutex);
+			if (--remaining == 0) {
+				done.notify_one();
+			}
+		});
+	}
+	this->wake.notify_all();
+
+	std::unique_lock<std::mutex> lock(doneMutex);
+	done.wait(lock, [&remaining] { return remaining == 0; });
+
+	for (const auto& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+	return results;
+}
@@ -0,0 +1,39 @@
+#include "typecheck/consistency_report.hpp"
+
+#include <algorithm>  // for find
+#include <string>
+
+using namespace typecheck;
+
+auto ConsistencyReport::consistent() const -> bool {
+	return this->_conflicting.empty() && this->_reason.empty();
+}
+
+auto ConsistencyReport::conflicting() const -> const std::vector<Constraint::IDType>& {
+	return this->_conflicting;
+}
+
+void ConsistencyReport::add_conflicting(const Constraint::IDType id) {
+	if (std::find(this->_conflicting.begin(), this->_conflicting.end(), id) == this->_conflicting.end()) {
+		this->_conflicting.push_back(id);
+	}
+}
+
+auto ConsistencyReport::reason() const -> const std::string& {
+	return this->_reason;
+}
+
+void ConsistencyReport::set_reason(const std::string& reason) {
+	this->_reason = reason;
+}
+
+auto ConsistencyReport::ShortDebugString() const -> std::string {
+	std::string out;
+	out += "{ \"reason\": \"" + this->_reason + "\", ";
+	out += "\"conflicting\": [";
+	for (std::size_t i = 0; i < this->_conflicting.size(); ++i) {
+		out += std::to_string(this->_conflicting.at(i)) + (i + 1 < this->_conflicting.size() ? ", " : " ");
+	}
+	out += "] }";
+	return out;
+}
@@ -0,0 +1,163 @@
+#include "typecheck/constraint_graph.hpp"
+#include "typecheck/union_find.hpp"
+
+#include <algorithm>  // for min
+#include <sstream>
+#include <string>
+#include <string_view>
+
+using namespace typecheck;
+
+namespace {
+	auto KindName(const ConstraintKind kind) -> std::string_view {
+		switch (kind) {
+		case Bind:
+			return "Bind";
+		case Equal:
+			return "Equal";
+		case BindParam:
+			return "BindParam";
+		case Conversion:
+			return "Conversion";
+		case ConformsTo:
+			return "ConformsTo";
+		case ApplicableFunction:
+			return "ApplicableFunction";
+		case BindOverload:
+			return "BindOverload";
+		}
+		return "Unknown";
+	}
+
+	// Symbols are generated, but registered names come from the user.
+	auto Escape(std::string_view str) -> std::string {
+		std::string out;
+		out.reserve(str.size());
+		for (const auto c : str) {
+			if (c == '"' || c == '\\') {
+				out.push_back('\\');
+				out.push_back(c);
+			} else if (c == '\n') {
+				out.append("\\n");
+			} else if (static_cast<unsigned char>(c) >= 0x20) {
+				out.push_back(c);
+			}
+		}
+		return out;
+	}
+}
+
+auto ConstraintGraph::variables() const -> const std::vector<Variable>& {
+	return this->_variables;
+}
+
+auto ConstraintGraph::constraints() const -> const std::vector<Node>& {
+	return this->_constraints;
+}
+
+auto ConstraintGraph::components() const -> std::size_t {
+	return this->_components;
+}
+
+auto ConstraintGraph::add_variable(const std::string& symbol, const std::size_t domain) -> std::size_t {
+	const auto [it, inserted] = this->index.emplace(symbol, this->_variables.size());
+	if (inserted) {
+		auto& var = this->_variables.emplace_back();
+		var.symbol = symbol;
+		var.domain = domain;
+	} else {
+		auto& var = this->_variables.at(it->second);
+		var.domain = std::min(var.domain, domain);
+	}
+	return it->second;
+}
+
+auto ConstraintGraph::add_constraint(const Constraint::IDType id, const ConstraintKind kind) -> Node* {
+	auto& node = this->_constraints.emplace_back();
+	node.id = id;
+	node.kind = kind;
+	return &node;
+}
+
+void ConstraintGraph::finalize() {
+	UnionFind sets;
+	for (auto& var : this->_variables) {
+		sets.add();
+		var.degree = 0;
+	}
+
+	for (const auto& node : this->_constraints) {
+		for (const auto var : node.variables) {
+			++this->_variables.at(var).degree;
+			sets.unite(node.variables.front(), var);
+		}
+	}
+
+	// Number the components densely, in the order their first variable was added.
+	std::unordered_map<std::size_t, std::size_t> roots;
+	for (std::size_t i = 0; i < this->_variables.size(); ++i) {
+		const auto [it, inserted] = roots.emplace(sets.find(i), roots.size());
+		this->_variables.at(i).component = it->second;
+	}
+	this->_components = roots.size();
+
+	for (auto& node : this->_constraints) {
+		if (node.variables.empty()) {
+			// Can't be connected to anything else.
+			node.component = this->_components++;
+		} else {
+			node.component = this->_variables.at(node.variables.front()).component;
+		}
+	}
+}
+
+auto ConstraintGraph::to_dot() const -> std::string {
+	std::ostringstream out;
+	out << "graph constraints {\n";
+	for (std::size_t i = 0; i < this->_variables.size(); ++i) {
+		const auto& var = this->_variables.at(i);
+		out << "\tv" << i << " [shape=ellipse, label=\"" << Escape(var.symbol)
+			<< "\\ndomain=" << var.domain << " degree=" << var.degree << " component=" << var.component << "\"];\n";
+	}
+
+	for (std::size_t i = 0; i < this->_constraints.size(); ++i) {
+		const auto& node = this->_constraints.at(i);
+		out << "\tc" << i << " [shape=box, label=\"" << KindName(node.kind) << " #" << node.id;
+		if (node.evaluations.has_value()) {
+			out << "\\nevaluations=" << *node.evaluations;
+		}
+		out << "\"];\n";
+
+		for (const auto var : node.variables) {
+			out << "\tc" << i << " -- v" << var << ";\n";
+		}
+	}
+	out << "}\n";
+	return out.str();
+}
+
+auto ConstraintGraph::to_json() const -> std::string {
+	std::ostringstream out;
+	out << "{\"components\":" << this->_components << ",\"variables\":[";
+	for (std::size_t i = 0; i < this->_variables.size(); ++i) {
+		const auto& var = this->_variables.at(i);
+		out << (i > 0 ? "," : "") << "{\"symbol\":\"" << Escape(var.symbol) << "\",\"domain\":" << var.domain
+			<< ",\"degree\":" << var.degree << ",\"component\":" << var.component << "}";
+	}
+
+	out << "],\"constraints\":[";
+	for (std::size_t i = 0; i < this->_constraints.size(); ++i) {
+		const auto& node = this->_constraints.at(i);
+		out << (i > 0 ? "," : "") << "{\"id\":" << node.id << ",\"kind\":\"" << KindName(node.kind) << "\",\"variables\":[";
+		for (std::size_t j = 0; j < node.variables.size(); ++j) {
+			out << (j > 0 ? "," : "") << node.variables.at(j);
+		}
+		out << "],\"component\":" << node.component;
+		if (node.evaluations.has_value()) {
+			out << ",\"evaluations\":" << *node.evaluations;
+		}
+		out << "}";
+	}
+	out << "]}";
+	return out.str();
+}
@@ -2,15 +2,14 @@
 
 #include "typecheck/type_var.hpp"  // for Constraint, ConstraintKind
 #include "typecheck/type.hpp"
-
-#include <iostream>
+#include "typecheck/debug_log.hpp"
 
 using namespace typecheck;
 
 auto ConstraintPass::getResolvedType(const TypeVar& var) const -> Type {
 	Type type;
     if (!this->hasResolvedType(var)) {
-        std::cout << "Typecheck Error: asking for unresolved type: " << var.symbol() << std::endl;
+        DebugLog::record(DebugLog::Event::UnresolvedType, var.symbol());
         return type;
     }
 
@@ -29,3 +28,7 @@ auto ConstraintPass::setResolvedType(const TypeVar& var, const Type& type) -> bo
 
     return false;
 }
+
+auto ConstraintPass::getResolvedTypes() const -> const std::unordered_map<std::string, Type>& {
+    return this->resolvedTypes;
+}
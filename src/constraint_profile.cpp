@@ -0,0 +1,53 @@
+#include "typecheck/constraint_profile.hpp"
+
+#include <algorithm>  // for partial_sort, min
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace typecheck;
+
+auto ConstraintProfile::entry(const Constraint::IDType id) -> Entry* {
+	auto& entry = this->entries[id];
+	entry.id = id;
+	return &entry;
+}
+
+auto ConstraintProfile::top(const std::size_t n) const -> std::vector<Entry> {
+	std::vector<Entry> sorted;
+	sorted.reserve(this->entries.size());
+	for (const auto& [id, entry] : this->entries) {
+		sorted.push_back(entry);
+	}
+
+	// Ties go to the most evaluated, then the oldest, so the order doesn't depend on the map.
+	const auto slower = [](const Entry& a, const Entry& b) {
+		if (a.time != b.time) {
+			return a.time > b.time;
+		} else if (a.evaluations != b.evaluations) {
+			return a.evaluations > b.evaluations;
+		}
+		return a.id < b.id;
+	};
+
+	const auto count = std::min(n, sorted.size());
+	std::partial_sort(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(count), sorted.end(), slower);
+	sorted.resize(count);
+	return sorted;
+}
+
+auto ConstraintProfile::size() const -> std::size_t {
+	return this->entries.size();
+}
+
+void ConstraintProfile::clear() {
+	this->entries.clear();
+}
+
+auto ConstraintProfile::ShortDebugString(const std::size_t n) const -> std::string {
+	std::ostringstream out;
+	for (const auto& entry : this->top(n)) {
+		out << "constraint " << entry.id << ": " << entry.evaluations << " evaluations, " << entry.failures << " failures, " << entry.time.count() << "ns\n";
+	}
+	return out.str();
+}
@@ -0,0 +1,35 @@
+#include "typecheck/counting_resource.hpp"
+
+#include <algorithm>  // for max
+
+using namespace typecheck;
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream) : _upstream(upstream) {}
+
+auto CountingResource::upstream() const noexcept -> std::pmr::memory_resource* {
+	return this->_upstream;
+}
+
+auto CountingResource::allocated() const noexcept -> std::size_t {
+	return this->_allocated;
+}
+
+auto CountingResource::peak() const noexcept -> std::size_t {
+	return this->_peak;
+}
+
+auto CountingResource::do_allocate(const std::size_t bytes, const std::size_t alignment) -> void* {
+	auto* p = this->_upstream->allocate(bytes, alignment);
+	this->_allocated += bytes;
+	this->_peak = std::max(this->_peak, this->_allocated);
+	return p;
+}
+
+void CountingResource::do_deallocate(void* p, const std::size_t bytes, const std::size_t alignment) {
+	this->_upstream->deallocate(p, bytes, alignment);
+	this->_allocated -= bytes;
+}
+
+auto CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool {
+	return this == &other;
+}
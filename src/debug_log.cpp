@@ -0,0 +1,181 @@
+#include "typecheck/debug_log.hpp"
+#include "typecheck/constraint.hpp"
+#include "typecheck/thread_rings.hpp"
+
+#include <cstring>    // for memcmp
+
+using namespace typecheck;
+
+namespace {
+	using Rings = ThreadRings<DebugLog::Record, 1 << 12>;
+
+	constexpr char MAGIC[4] = {'T', 'C', 'D', 'L'};
+	constexpr std::uint32_t VERSION = 1;
+
+	struct Header {
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t recordSize;
+	};
+
+	auto KindName(const std::uint8_t kind) -> std::string_view {
+		switch (static_cast<ConstraintKind>(kind)) {
+		case Bind:
+			return "Bind";
+		case Equal:
+			return "Equal";
+		case BindParam:
+			return "BindParam";
+		case Conversion:
+			return "Conversion";
+		case ConformsTo:
+			return "ConformsTo";
+		case ApplicableFunction:
+			return "ApplicableFunction";
+		case BindOverload:
+			return "BindOverload";
+		}
+		return "Unknown";
+	}
+
+	auto EventName(const DebugLog::Event event) -> std::string_view {
+		switch (event) {
+		case DebugLog::Event::CreateConstraint:
+			return "create";
+		case DebugLog::Event::EmptyDomain:
+			return "warning: empty domain";
+		case DebugLog::Event::UnsupportedLiteral:
+			return "warning: unsupported literal";
+		case DebugLog::Event::MalformedConstraint:
+			return "warning: malformed";
+		case DebugLog::Event::UnknownConstraint:
+			return "warning: unknown constraint kind";
+		case DebugLog::Event::UnresolvedType:
+			return "error: unresolved type";
+		}
+		return "unknown event";
+	}
+
+	auto HasConstraint(const DebugLog::Event event) -> bool {
+		return event != DebugLog::Event::EmptyDomain && event != DebugLog::Event::UnresolvedType;
+	}
+}
+
+void DebugLog::record(const Record& record) {
+	Rings::push(record);
+}
+
+void DebugLog::record(const Event event, const Constraint& constraint) {
+	Record record{event, static_cast<std::uint8_t>(constraint.kind()), 0, 0, constraint.id(), NONE, {NONE, NONE, NONE}};
+	const auto add = [&record](const TypeVar& var) {
+		if (record.numVars < MAX_VARS) {
+			record.vars[record.numVars] = DebugLog::varIndex(var.symbol());
+		}
+		++record.numVars;
+	};
+
+	if (constraint.has_types()) {
+		const auto& types = constraint.types();
+		if (types.has_first()) {
+			add(types.first());
+		}
+		if (types.has_second()) {
+			add(types.second());
+		}
+		if (types.has_third()) {
+			add(types.third());
+		}
+	} else if (constraint.has_conforms()) {
+		if (constraint.conforms().has_type()) {
+			add(constraint.conforms().type());
+		}
+		if (constraint.conforms().has_protocol() && constraint.conforms().protocol().has_literal()) {
+			record.detail = constraint.conforms().protocol().literal();
+		}
+	} else if (constraint.has_overload()) {
+		const auto& overload = constraint.overload();
+		record.detail = overload.functionid();
+		if (overload.has_type()) {
+			add(overload.type());
+		}
+		add(overload.returnvar());
+		for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+			add(overload.argvars(i));
+		}
+	} else if (constraint.has_explicit_() && constraint.explicit_().has_var()) {
+		add(constraint.explicit_().var());
+	}
+
+	Rings::push(record);
+}
+
+void DebugLog::record(const Event event, const std::string_view var) {
+	Rings::push(Record{event, 0, 0, 1, NONE, NONE, {DebugLog::varIndex(var), NONE, NONE}});
+}
+
+auto DebugLog::varIndex(const std::string_view symbol) -> std::int64_t {
+	auto first = symbol.size();
+	while (first > 0 && symbol.at(first - 1) >= '0' && symbol.at(first - 1) <= '9') {
+		--first;
+	}
+	if (first == symbol.size()) {
+		return NONE;
+	}
+
+	std::int64_t index = 0;
+	for (auto i = first; i < symbol.size(); ++i) {
+		index = index * 10 + (symbol.at(i) - '0');
+	}
+	return index;
+}
+
+void DebugLog::flush(std::ostream& out) {
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.recordSize = sizeof(Record);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	Rings::drain([&out](const std::size_t thread, Record record) {
+		record.thread = static_cast<std::uint16_t>(thread);
+		out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+	});
+}
+
+auto DebugLog::decode(std::istream& in, std::ostream& out) -> bool {
+	Header header{};
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.recordSize != sizeof(Record)) {
+		return false;
+	}
+
+	Record record{};
+	while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+		out << "[" << record.thread << "] " << EventName(record.event);
+		if (HasConstraint(record.event)) {
+			out << " " << KindName(record.kind) << " " << record.constraint;
+		}
+		if (record.detail != NONE) {
+			out << " #" << record.detail;
+		}
+		for (std::size_t i = 0; i < MAX_VARS && i < record.numVars; ++i) {
+			if (record.vars[i] == NONE) {
+				out << " ?";
+			} else {
+				out << " T" << record.vars[i];
+			}
+		}
+		if (record.numVars > MAX_VARS) {
+			out << " ...";
+		}
+		out << '\n';
+	}
+	return in.eof();
+}
+
+auto DebugLog::dropped() -> std::size_t {
+	return Rings::dropped();
+}
+
+auto DebugLog::buffers() -> std::size_t {
+	return Rings::rings();
+}
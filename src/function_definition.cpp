@@ -24,6 +24,8 @@ void FunctionDefinition::CopyFrom(const FunctionDefinition& other) {
 	if (other.has_returntype()) {
 		this->_returnType = std::make_unique<Type>();
 		this->_returnType->CopyFrom(other.returntype());
+	} else {
+		this->_returnType.reset();
 	}
 
 	this->_name = other._name;
@@ -32,7 +34,7 @@ void FunctionDefinition::CopyFrom(const FunctionDefinition& other) {
 
 auto FunctionDefinition::operator==(const FunctionDefinition& other) const noexcept -> bool {
 	const auto args_same = this->args_size() == other.args_size() &&
-		this->name() == other.name() &&
+		this->_name == other._name &&
 		this->id() == other.id() &&
 		this->has_returntype() == other.has_returntype() &&
 		// This is the most expensive, do it last
@@ -80,7 +82,7 @@ auto FunctionDefinition::args(std::size_t i) const -> const Type& {
 	return this->_args.at(i);
 }
 
-auto FunctionDefinition::name() const -> std::string {
+auto FunctionDefinition::name() const noexcept -> const std::string& {
 	return this->_name;
 }
 
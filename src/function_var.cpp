@@ -9,7 +9,7 @@ using namespace typecheck;
 
 FunctionVar::FunctionVar() : _id(0) {}
 
-auto FunctionVar::name() const -> std::string {
+auto FunctionVar::name() const noexcept -> const std::string& {
     return this->_name;
 }
 
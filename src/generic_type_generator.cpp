@@ -3,13 +3,24 @@
 #include <algorithm>  // for reverse
 #include <string>     // for basic_string
 #include <vector>     // for vector<>::iterator, vector
+#include <utility>    // for move
 
 using namespace typecheck;
 
+GenericTypeGenerator::GenericTypeGenerator(std::string prefix) : _prefix(std::move(prefix)) {}
+
 auto GenericTypeGenerator::next_id() -> long long {
 	return this->curr_num++;
 }
 
+auto GenericTypeGenerator::count() const noexcept -> value_type {
+	return this->curr_num;
+}
+
+void GenericTypeGenerator::reset(const value_type next) {
+	this->curr_num = next;
+}
+
 auto GenericTypeGenerator::next() -> std::string {
-    return "T" + std::to_string(this->next_id());
+    return this->_prefix + std::to_string(this->next_id());
 }
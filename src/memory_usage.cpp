@@ -0,0 +1,71 @@
+#include "typecheck/memory_usage.hpp"
+#include "typecheck/constraint.hpp"
+#include "typecheck/function_var.hpp"
+#include "typecheck/type.hpp"
+#include "typecheck/type_var.hpp"
+
+using namespace typecheck;
+
+namespace {
+	// Short strings are stored inline.
+	const auto INLINE_CAPACITY = std::string().capacity();
+}
+
+auto heap::bytes(const std::string& str) -> std::size_t {
+	return str.capacity() > INLINE_CAPACITY ? str.capacity() + 1 : 0;
+}
+
+auto heap::bytes(const TypeVar& var) -> std::size_t {
+	return bytes(var.symbol());
+}
+
+auto heap::bytes(const Type& type) -> std::size_t {
+	if (type.has_raw()) {
+		return bytes(type.raw().name());
+	}
+	if (!type.has_func()) {
+		return 0;
+	}
+
+	const auto& func = type.func();
+	auto total = bytes(func.name()) + func.args_size() * sizeof(Type);
+	for (std::size_t i = 0; i < func.args_size(); ++i) {
+		total += bytes(func.args(i));
+	}
+	if (func.has_returntype()) {
+		total += sizeof(Type) + bytes(func.returntype());
+	}
+	return total;
+}
+
+auto heap::bytes(const FunctionVar& func) -> std::size_t {
+	return bytes(func.args()) + bytes(func.returnvar()) + bytes(func.name());
+}
+
+auto heap::bytes(const Constraint& constraint) -> std::size_t {
+	std::size_t total = 0;
+	if (constraint.has_types()) {
+		const auto& types = constraint.types();
+		total += types.has_first() ? bytes(types.first()) : 0;
+		total += types.has_second() ? bytes(types.second()) : 0;
+		total += types.has_third() ? bytes(types.third()) : 0;
+	}
+	if (constraint.has_explicit_()) {
+		const auto& explicit_ = constraint.explicit_();
+		total += explicit_.has_var() ? bytes(explicit_.var()) : 0;
+		total += explicit_.has_type() ? bytes(explicit_.type()) : 0;
+	}
+	if (constraint.has_overload()) {
+		const auto& overload = constraint.overload();
+		total += overload.has_type() ? bytes(overload.type()) : 0;
+		total += bytes(overload.returnvar());
+		total += overload.argvars_size() * sizeof(TypeVar);
+		for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+			total += bytes(overload.argvars(i));
+		}
+	}
+	if (constraint.has_conforms() && constraint.conforms().has_type()) {
+		total += bytes(constraint.conforms().type());
+	}
+	return total;
+}
@@ -0,0 +1,125 @@
+#include "typecheck/overload_table.hpp"
+
+#include <algorithm>  // for find, sort, set_intersection, remove_if, binary_search
+#include <iterator>   // for back_inserter
+#include <utility>
+
+using namespace typecheck;
+
+namespace {
+	auto Sorted(std::vector<std::size_t> values) -> std::vector<std::size_t> {
+		std::sort(values.begin(), values.end());
+		return values;
+	}
+
+	// Keeps the order of the domain, the search tries values in that order.
+	auto Retain(std::vector<std::size_t>& domain, const std::vector<std::size_t>& sortedAllowed) -> bool {
+		const auto before = domain.size();
+		domain.erase(std::remove_if(domain.begin(), domain.end(), [&sortedAllowed](const std::size_t value) {
+			return !std::binary_search(sortedAllowed.begin(), sortedAllowed.end(), value);
+		}), domain.end());
+		return domain.size() != before;
+	}
+}
+
+OverloadTable::OverloadTable(const VarIndex typeVar, std::vector<VarIndex> callVars) : type(typeVar), call(std::move(callVars)) {}
+
+void OverloadTable::add_row(const ValueID function, std::vector<VarIndex> definition) {
+	const auto exists = std::find_if(this->_rows.begin(), this->_rows.end(), [function](const Row& row) {
+		return row.function == function;
+	});
+	if (exists == this->_rows.end()) {
+		this->_rows.push_back({function, std::move(definition)});
+	}
+}
+
+auto OverloadTable::rows() const -> const std::vector<Row>& {
+	return this->_rows;
+}
+
+auto OverloadTable::scope() const -> std::vector<VarIndex> {
+	std::vector<VarIndex> vars{this->type};
+	auto add = [&vars](const VarIndex var) {
+		if (std::find(vars.begin(), vars.end(), var) == vars.end()) {
+			vars.push_back(var);
+		}
+	};
+
+	for (const auto& var : this->call) {
+		add(var);
+	}
+	for (const auto& row : this->_rows) {
+		for (const auto& var : row.definition) {
+			add(var);
+		}
+	}
+	return vars;
+}
+
+auto OverloadTable::propagate(std::vector<std::vector<ValueID>>& domains, std::vector<VarIndex>* narrowed) const -> bool {
+	const auto types = Sorted(domains.at(this->type));
+	std::vector<std::vector<ValueID>> callValues;
+	for (const auto& var : this->call) {
+		callValues.push_back(Sorted(domains.at(var)));
+	}
+
+	// Values of each column some row still allows, and the values of the only row left.
+	std::vector<std::vector<ValueID>> supported(this->call.size());
+	std::vector<ValueID> functions;
+	const Row* only = nullptr;
+	std::vector<std::vector<ValueID>> onlyColumns;
+
+	for (const auto& row : this->_rows) {
+		if (row.definition.size() != this->call.size() || !std::binary_search(types.begin(), types.end(), row.function)) {
+			continue;
+		}
+
+		// A row is supported while each call variable can still equal its definition variable.
+		std::vector<std::vector<ValueID>> columns;
+		bool supports = true;
+		for (std::size_t i = 0; i < this->call.size() && supports; ++i) {
+			const auto definitionValues = Sorted(domains.at(row.definition.at(i)));
+			auto& column = columns.emplace_back();
+			std::set_intersection(callValues.at(i).begin(), callValues.at(i).end(), definitionValues.begin(), definitionValues.end(), std::back_inserter(column));
+			supports = !column.empty();
+		}
+		if (!supports) {
+			continue;
+		}
+
+		for (std::size_t i = 0; i < columns.size(); ++i) {
+			supported.at(i).insert(supported.at(i).end(), columns.at(i).begin(), columns.at(i).end());
+		}
+		functions.push_back(row.function);
+		only = functions.size() == 1 ? &row : nullptr;
+		if (only != nullptr) {
+			onlyColumns = std::move(columns);
+		}
+	}
+
+	auto retain = [&domains, narrowed](const VarIndex var, const std::vector<ValueID>& sortedAllowed) {
+		if (Retain(domains.at(var), sortedAllowed)) {
+			narrowed->push_back(var);
+		}
+		return !domains.at(var).empty();
+	};
+
+	if (!retain(this->type, Sorted(std::move(functions)))) {
+		return false;
+	}
+	for (std::size_t i = 0; i < this->call.size(); ++i) {
+		if (!retain(this->call.at(i), Sorted(std::move(supported.at(i))))) {
+			return false;
+		}
+	}
+
+	// The call has to use this overload, so its definition has to match the call too.
+	if (only != nullptr) {
+		for (std::size_t i = 0; i < this->call.size(); ++i) {
+			if (!retain(only->definition.at(i), onlyColumns.at(i))) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
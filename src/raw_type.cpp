@@ -6,18 +6,26 @@ using namespace typecheck;
 RawType::RawType(std::string n) : _name(std::move(n)) {}
 
 void RawType::CopyFrom(const RawType& other) {
-	this->_name = other.name();
+	this->_name = other._name;
 }
 
 auto RawType::operator==(const RawType& other) const noexcept -> bool {
-	return this->name() == other.name();
+	return this->_name == other._name;
 }
 
 auto RawType::operator!=(const RawType& other) const noexcept -> bool {
 	return !(*this == other);
 }
 
-auto RawType::name() const -> std::string {
+auto RawType::operator==(std::string_view name) const noexcept -> bool {
+	return this->_name == name;
+}
+
+auto RawType::operator!=(std::string_view name) const noexcept -> bool {
+	return !(*this == name);
+}
+
+auto RawType::name() const noexcept -> const std::string& {
 	return this->_name;
 }
 
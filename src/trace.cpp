@@ -0,0 +1,47 @@
+#include "typecheck/trace.hpp"
+#include "typecheck/thread_rings.hpp"
+
+#include <algorithm>  // for max
+
+using namespace typecheck;
+
+namespace {
+	using Rings = ThreadRings<TraceLog::Span, 1 << 13>;
+
+	// Timestamps start from when the library was loaded.
+	const auto EPOCH = TraceLog::Clock::now();
+
+	// Trace-event timestamps are in microseconds.
+	void WriteMicroseconds(std::ostream& out, const std::int64_t nanoseconds) {
+		out << nanoseconds / 1000 << '.';
+		const auto fraction = nanoseconds % 1000;
+		out << (fraction < 100 ? "0" : "") << (fraction < 10 ? "0" : "") << fraction;
+	}
+}
+
+void TraceLog::record(const char* name, const Clock::time_point begin, const Clock::time_point end) {
+	const auto since = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - EPOCH).count();
+	Rings::push(Span{name, std::max<std::int64_t>(since, 0), std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()});
+}
+
+void TraceLog::flush(std::ostream& out) {
+	out << "{\"traceEvents\":[";
+	bool first = true;
+	Rings::drain([&out, &first](const std::size_t thread, const Span& span) {
+		out << (first ? "" : ",") << "{\"name\":\"" << span.name << "\",\"cat\":\"typecheck\",\"ph\":\"X\",\"ts\":";
+		WriteMicroseconds(out, span.begin);
+		out << ",\"dur\":";
+		WriteMicroseconds(out, span.duration);
+		out << ",\"pid\":1,\"tid\":" << thread << "}";
+		first = false;
+	});
+	out << "],\"displayTimeUnit\":\"ns\"}";
+}
+
+auto TraceLog::dropped() -> std::size_t {
+	return Rings::dropped();
+}
+
+auto TraceLog::buffers() -> std::size_t {
+	return Rings::rings();
+}
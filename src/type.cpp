@@ -2,6 +2,8 @@
 #include <typecheck/raw_type.hpp>
 #include <typecheck/function_definition.hpp>
 
+#include <functional>
+#include <string_view>
 #include <variant>
 #include <iostream>
 
@@ -46,6 +48,29 @@ auto Type::operator==(const Type& other) const noexcept -> bool {
 	}
 }
 
+auto Type::hash() const noexcept -> std::size_t {
+	auto combine = [](std::size_t& seed, const std::size_t value) {
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	};
+
+	if (this->has_raw()) {
+		return std::hash<std::string_view>()(this->raw().name());
+	} else if (!this->has_func()) {
+		return 0;
+	}
+
+	const auto& func = this->func();
+	auto seed = std::hash<std::string_view>()(func.name());
+	combine(seed, std::hash<long long>()(func.id()));
+	if (func.has_returntype()) {
+		combine(seed, func.returntype().hash());
+	}
+	for (std::size_t i = 0; i < func.args_size(); ++i) {
+		combine(seed, func.args(i).hash());
+	}
+	return seed;
+}
+
 auto Type::CopyFrom(const Type& other) -> Type& {
 	if (this == &other) {
 		return *this;
@@ -0,0 +1,137 @@
+#include <typecheck/type_factory.hpp>
+#include <typecheck/debug.hpp>
+#include <typecheck/memory_usage.hpp>
+
+#include <functional>  // for hash
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace typecheck;
+
+namespace {
+	void HashCombine(std::size_t& seed, const std::size_t value) {
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+}
+
+TypeFactory::Ref::Ref(const Node* n) : node(n) {}
+
+auto TypeFactory::Ref::operator==(const Ref& other) const noexcept -> bool {
+	return this->node == other.node;
+}
+
+auto TypeFactory::Ref::operator!=(const Ref& other) const noexcept -> bool {
+	return !(*this == other);
+}
+
+TypeFactory::Ref::operator bool() const noexcept {
+	return this->node != nullptr;
+}
+
+auto TypeFactory::Ref::is_function() const -> bool {
+	return this->node->type.has_func();
+}
+
+auto TypeFactory::Ref::hash() const noexcept -> std::size_t {
+	return this->node != nullptr ? this->node->hash : 0;
+}
+
+auto TypeFactory::Ref::type() const -> const Type& {
+	TYPECHECK_ASSERT(this->node != nullptr, "Must not dereference an empty Ref.");
+	return this->node->type;
+}
+
+auto TypeFactory::raw(std::string_view name) -> Ref {
+	const auto it = this->raws.find(name);
+	if (it != this->raws.end()) {
+		return Ref(it->second);
+	}
+
+	auto& node = this->nodes.emplace_back();
+	node.type.mutable_raw()->set_name(std::string(name));
+	node.hash = std::hash<std::string_view>()(name);
+	this->raws.emplace(node.type.raw().name(), &node);
+	return Ref(&node);
+}
+
+auto TypeFactory::function(std::string_view name, const long long id, const std::vector<Ref>& args, const Ref& returnType) -> Ref {
+	std::size_t hash = std::hash<std::string_view>()(name);
+	HashCombine(hash, std::hash<long long>()(id));
+	HashCombine(hash, returnType.hash());
+	for (const auto& arg : args) {
+		HashCombine(hash, arg.hash());
+	}
+
+	// Children are already unique, so only need to compare them by address.
+	const auto [begin, end] = this->functions.equal_range(hash);
+	for (auto it = begin; it != end; ++it) {
+		const auto* candidate = it->second;
+		const auto& func = candidate->type.func();
+		if (candidate->returnType != returnType.node || candidate->args.size() != args.size() || func.id() != id || func.name() != name) {
+			continue;
+		}
+
+		bool same = true;
+		for (std::size_t i = 0; i < args.size() && same; ++i) {
+			same = candidate->args.at(i) == args.at(i).node;
+		}
+		if (same) {
+			return Ref(candidate);
+		}
+	}
+
+	auto& node = this->nodes.emplace_back();
+	node.hash = hash;
+	node.returnType = returnType.node;
+
+	auto* func = node.type.mutable_func();
+	func->set_name(std::string(name));
+	func->set_id(id);
+	if (returnType) {
+		func->mutable_returntype()->CopyFrom(returnType.type());
+	}
+	for (const auto& arg : args) {
+		node.args.push_back(arg.node);
+		func->add_args()->CopyFrom(arg.type());
+	}
+
+	this->functions.emplace(hash, &node);
+	return Ref(&node);
+}
+
+auto TypeFactory::intern(const Type& type) -> Ref {
+	if (type.has_raw()) {
+		return this->raw(type.raw().name());
+	} else if (!type.has_func()) {
+		return {};
+	}
+
+	const auto& func = type.func();
+	std::vector<Ref> args;
+	args.reserve(func.args_size());
+	for (std::size_t i = 0; i < func.args_size(); ++i) {
+		args.push_back(this->intern(func.args(i)));
+	}
+
+	const auto returnType = func.has_returntype() ? this->intern(func.returntype()) : Ref{};
+	return this->function(func.name(), func.id(), args, returnType);
+}
+
+auto TypeFactory::size() const noexcept -> std::size_t {
+	return this->nodes.size();
+}
+
+auto TypeFactory::memoryUsage() const -> std::size_t {
+	auto total = this->nodes.size() * sizeof(Node) + heap::bytes(this->raws) + heap::bytes(this->functions);
+	for (const auto& node : this->nodes) {
+		total += heap::bytes(node.type) + heap::bytes(node.args);
+	}
+	return total;
+}
+
+void TypeFactory::clear() {
+	this->raws.clear();
+	this->functions.clear();
+	this->nodes.clear();
+}
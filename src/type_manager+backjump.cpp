@@ -0,0 +1,363 @@
+#include <typecheck/type_manager.hpp>
+#include <typecheck/backjump_solver.hpp>
+#include <typecheck/constraint.hpp>
+#include <typecheck/overload_table.hpp>
+
+#include <typecheck/protocols/ExpressibleByFloatLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByIntegerLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByDoubleLiteral.hpp>
+
+#include <algorithm>  // for find, rotate
+#include <map>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace typecheck;
+
+namespace {
+	// Defaulting literals one at a time takes a solve each, with more than this it's left to the optimizing search.
+	constexpr std::size_t DEFAULTING_LIMIT = 64;
+
+	using ValueID = BackjumpSolver::ValueID;
+	using VarIndex = BackjumpSolver::VarIndex;
+
+	class ValueTable {
+	public:
+		explicit ValueTable(std::pmr::memory_resource* resource) : ids(resource) {}
+
+		auto id(const std::string& value) -> ValueID {
+			const auto it = this->ids.find(value);
+			if (it != this->ids.end()) {
+				return it->second;
+			}
+			const auto id = this->ids.emplace(value, this->ids.size()).first;
+			this->values.push_back(&id->first);
+			return id->second;
+		}
+
+		auto value(const ValueID id) const -> const std::string& {
+			return *this->values.at(id);
+		}
+
+		auto find(const std::string& value) const -> std::pair<bool, ValueID> {
+			const auto it = this->ids.find(value);
+			return it == this->ids.end() ? std::make_pair(false, ValueID{}) : std::make_pair(true, it->second);
+		}
+
+	private:
+		std::pmr::unordered_map<std::string, ValueID> ids;
+		std::vector<const std::string*> values;
+	};
+
+	template<typename T>
+	auto LiteralProtocolValues(ValueTable& table) -> std::set<ValueID> {
+		T protocol;
+		std::set<ValueID> values;
+		for (const auto& ty : protocol.getPreferredTypes()) {
+			values.insert(table.id(ty.raw().name()));
+		}
+
+		for (const auto& ty : protocol.getOtherTypes()) {
+			values.insert(table.id(ty.raw().name()));
+		}
+		return values;
+	}
+}
+
+auto TypeManager::checkSatisfiable(const SimplifiedConstraints& system, const OverloadCandidates& overloads, const Hints& hints, ConsistencyReport* report, std::pmr::memory_resource* resource, const std::size_t nodeLimit, ObserverRef* observer, Assignments* defaulted) const -> BackjumpSolver::Result {
+	BackjumpSolver solver;
+	solver.setNodeLimit(nodeLimit);
+
+	// Mirrors the domains built in `solve`, interned so the search only compares integers.
+	ValueTable table(resource);
+	std::vector<ValueID> varDomain;
+	for (const auto* layer : this->registries()) {
+		for (const auto& ty : layer->types()) {
+			if (ty.has_raw()) {
+				varDomain.push_back(table.id(ty.raw().name()));
+			} else if (ty.has_func()) {
+				varDomain.push_back(table.id(ty.func().name()));
+			}
+		}
+	}
+	for (const auto* layer : this->registries()) {
+		for (const auto& func : layer->functions()) {
+			varDomain.push_back(table.id(func.serialize()));
+		}
+	}
+
+	// Filled in once every value is interned, only read during the search.
+	std::pmr::set<std::pair<ValueID, ValueID>> conversions(resource);
+
+	// Hinted values are tried first, and assumed when defaulting the literals.
+	std::vector<std::pair<VarIndex, ValueID>> hinted;
+
+	std::pmr::map<std::string, VarIndex> vars(resource);
+	auto var_index = [&solver, &vars, &hints, &table, &hinted](const std::string& var, const std::vector<ValueID>& domain) {
+		const auto it = vars.find(var);
+		if (it != vars.end()) {
+			return it->second;
+		}
+
+		const auto hint = hints.find(var);
+		const auto value = hint == hints.end() ? std::make_pair(false, ValueID{}) : table.find(std::string(hint->second));
+		const auto position = std::find(domain.begin(), domain.end(), value.second);
+		if (!value.first || position == domain.end()) {
+			return vars.emplace(var, solver.addVariable(domain)).first->second;
+		}
+
+		auto ordered = domain;
+		const auto offset = position - domain.begin();
+		std::rotate(ordered.begin(), ordered.begin() + offset, ordered.begin() + offset + 1);
+		const auto index = vars.emplace(var, solver.addVariable(std::move(ordered))).first->second;
+		hinted.emplace_back(index, value.second);
+		return index;
+	};
+
+	// Shared overloads have concrete types, so there is only one choice.
+	auto func_var_domain = [this, &table, &varDomain](const std::string& var) {
+		if (!this->shared->hasBoundType(var)) {
+			return varDomain;
+		}
+
+		const auto& type = this->shared->getBoundType(var);
+		return std::vector<ValueID>{table.id(type.has_func() ? type.func().name() : type.raw().name())};
+	};
+
+	// Each literal and its preferred type, in the order they were constrained.
+	std::vector<std::pair<VarIndex, ValueID>> literals;
+	const std::set<ValueID> registered(varDomain.begin(), varDomain.end());
+	auto add_literal = [&table, &registered, &literals](const VarIndex var, const Type& preferred) {
+		const auto value = table.find(preferred.raw().name());
+		if (value.first && registered.find(value.second) != registered.end()) {
+			literals.emplace_back(var, value.second);
+		}
+	};
+
+	for (const auto* constraintPtr : system.kept) {
+		const auto& constraint = *constraintPtr;
+		if (constraint.has_conforms()) {
+			const auto& conforms = constraint.conforms();
+			if (!conforms.has_type() || !conforms.has_protocol() || !conforms.protocol().has_literal()) {
+				return BackjumpSolver::Unknown;
+			}
+
+			std::set<ValueID> allowed;
+			switch (conforms.protocol().literal()) {
+			case KnownProtocolKind::ExpressibleByFloat:
+				allowed = LiteralProtocolValues<ExpressibleByFloatLiteral>(table);
+				break;
+			case KnownProtocolKind::ExpressibleByDouble:
+				allowed = LiteralProtocolValues<ExpressibleByDoubleLiteral>(table);
+				break;
+			case KnownProtocolKind::ExpressibleByInteger:
+				allowed = LiteralProtocolValues<ExpressibleByIntegerLiteral>(table);
+				break;
+			case KnownProtocolKind::ExpressibleByArray:
+			case KnownProtocolKind::ExpressibleByBoolean:
+			case KnownProtocolKind::ExpressibleByDictionary:
+			case KnownProtocolKind::ExpressibleByNil:
+			case KnownProtocolKind::ExpressibleByString:
+				return BackjumpSolver::Unknown;
+			}
+
+			const auto var = var_index(conforms.type().symbol(), varDomain);
+			switch (conforms.protocol().literal()) {
+			case KnownProtocolKind::ExpressibleByFloat:
+				add_literal(var, ExpressibleByFloatLiteral().getPreferredTypes().front());
+				break;
+			case KnownProtocolKind::ExpressibleByDouble:
+				add_literal(var, ExpressibleByDoubleLiteral().getPreferredTypes().front());
+				break;
+			case KnownProtocolKind::ExpressibleByInteger:
+				add_literal(var, ExpressibleByIntegerLiteral().getPreferredTypes().front());
+				break;
+			case KnownProtocolKind::ExpressibleByArray:
+			case KnownProtocolKind::ExpressibleByBoolean:
+			case KnownProtocolKind::ExpressibleByDictionary:
+			case KnownProtocolKind::ExpressibleByNil:
+			case KnownProtocolKind::ExpressibleByString:
+				break;
+			}
+
+			solver.addConstraint(constraint.id(), {var}, [var, allowed = std::move(allowed)](const BackjumpSolver::Assignment& a) {
+				return allowed.find(a.at(var)) != allowed.end();
+			});
+		} else if (constraint.has_types()) {
+			const auto& types = constraint.types();
+			std::vector<VarIndex> scope;
+			if (types.has_first()) {
+				scope.push_back(var_index(types.first().symbol(), varDomain));
+			}
+			if (types.has_second()) {
+				scope.push_back(var_index(types.second().symbol(), varDomain));
+			}
+			if (types.has_third()) {
+				scope.push_back(var_index(types.third().symbol(), varDomain));
+			}
+
+			if (scope.empty()) {
+				continue;
+			}
+
+			switch (constraint.kind()) {
+			case Conversion:
+				if (scope.size() < 2) {
+					return BackjumpSolver::Unknown;
+				}
+				solver.addConstraint(constraint.id(), scope, [from = scope.at(0), to = scope.at(1), &conversions](const BackjumpSolver::Assignment& a) {
+					return a.at(from) == a.at(to) || conversions.find({a.at(from), a.at(to)}) != conversions.end();
+				});
+				break;
+			case Equal:
+				solver.addConstraint(constraint.id(), scope, [scope](const BackjumpSolver::Assignment& a) {
+					for (const auto& var : scope) {
+						if (a.at(var) != a.at(scope.front())) {
+							return false;
+						}
+					}
+					return true;
+				});
+				break;
+			case Bind:
+			case BindParam:
+			case BindOverload:
+			case ConformsTo:
+			case ApplicableFunction:
+			default:
+				return BackjumpSolver::Unknown;
+			}
+		} else if (constraint.has_overload()) {
+			const auto& overload = constraint.overload();
+			const auto& funcFamily = overloads.at(constraint.id());
+
+			std::vector<ValueID> typeDomain;
+			for (const auto& func : funcFamily) {
+				typeDomain.push_back(table.id(func.serialize()));
+			}
+
+			// One table for every overload, with the return type first then the args, of the call and each definition.
+			const auto typeVar = var_index(overload.type().symbol(), typeDomain);
+			std::vector<VarIndex> callVars{var_index(overload.returnvar().symbol(), varDomain)};
+			for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+				callVars.push_back(var_index(overload.argvars(i).symbol(), varDomain));
+			}
+
+			OverloadTable overloadTable(typeVar, std::move(callVars));
+			for (const auto& func : funcFamily) {
+				std::vector<VarIndex> definition{var_index(func.returnvar().symbol(), func_var_domain(func.returnvar().symbol()))};
+				for (const auto& arg : func.args()) {
+					definition.push_back(var_index(arg.symbol(), func_var_domain(arg.symbol())));
+				}
+				overloadTable.add_row(table.id(func.serialize()), std::move(definition));
+			}
+			solver.addTable(constraint.id(), std::move(overloadTable));
+		} else if (constraint.has_explicit_()) {
+			const auto& explicit_ = constraint.explicit_();
+			if (!explicit_.has_var() || !explicit_.has_type()) {
+				return BackjumpSolver::Unknown;
+			}
+
+			const auto var = var_index(explicit_.var().symbol(), varDomain);
+			const auto& type = explicit_.type();
+			const auto bound = type.has_raw() ? table.find(type.raw().name()) : std::make_pair(false, ValueID{});
+			solver.addConstraint(constraint.id(), {var}, [var, bound](const BackjumpSolver::Assignment& a) {
+				return bound.first && a.at(var) == bound.second;
+			});
+		} else {
+			return BackjumpSolver::Unknown;
+		}
+	}
+
+	// Not constrained any more, but still need a type.
+	for (const auto* constraint : system.dropped) {
+		if (constraint->has_types() && constraint->types().has_first()) {
+			var_index(constraint->types().first().symbol(), varDomain);
+		}
+	}
+
+	for (const auto* layer : this->registries()) {
+		for (const auto& [from, tos] : layer->conversions()) {
+			const auto fromValue = table.find(from);
+			for (const auto& to : tos) {
+				const auto toValue = table.find(to);
+				if (fromValue.first && toValue.first) {
+					conversions.emplace(fromValue.second, toValue.second);
+				}
+			}
+		}
+	}
+
+	const auto result = observer == nullptr ? solver.solve() : solver.search(*observer);
+	if (result == BackjumpSolver::Unsatisfiable) {
+		report->set_reason("No assignment satisfies every constraint");
+		for (const auto& id : solver.conflict()) {
+			report->add_conflicting(id);
+		}
+	}
+
+	if (result != BackjumpSolver::Satisfiable || defaulted == nullptr) {
+		return result;
+	}
+
+	// The searches for defaults go to the observer as well.
+	NullObserver none;
+	auto search = [&solver, &none, observer](const std::vector<std::pair<VarIndex, ValueID>>& assumptions) {
+		return observer == nullptr ? solver.search(assumptions, none) : solver.search(assumptions, *observer);
+	};
+
+	// Give every literal its preferred type, which is what the optimizing search is looking for.
+	// Keeping the hints as well is just as good, and usually what a warm start wants.
+	auto defaults = literals;
+	defaults.insert(defaults.end(), hinted.begin(), hinted.end());
+	auto outcome = search(defaults);
+	if (outcome == BackjumpSolver::Unsatisfiable && !hinted.empty()) {
+		// Hints are only hints, try again without them.
+		defaults = literals;
+		outcome = search(defaults);
+	}
+
+	// Running out of nodes proves nothing either way, so leave it to the optimizing search.
+	if (outcome == BackjumpSolver::Unknown) {
+		return result;
+	}
+
+	if (outcome == BackjumpSolver::Unsatisfiable) {
+		if (literals.size() > DEFAULTING_LIMIT) {
+			return result;
+		}
+
+		// One at a time instead, skipping those that conflict with the ones before.
+		defaults.clear();
+		for (const auto& literal : literals) {
+			defaults.push_back(literal);
+			const auto together = search(defaults);
+			if (together == BackjumpSolver::Satisfiable) {
+				continue;
+			}
+			defaults.pop_back();
+			if (together == BackjumpSolver::Unknown) {
+				return result;
+			}
+
+			if (search({literal}) != BackjumpSolver::Unsatisfiable) {
+				// Only conflicts because of another literal's default, so there is a choice to make (or the search gave up before telling).
+				return result;
+			}
+			// Never gets its preferred type, so no solution can do better.
+		}
+
+		if (search(defaults) != BackjumpSolver::Satisfiable) {
+			return result;
+		}
+	}
+
+	for (const auto& [symbol, var] : vars) {
+		defaulted->emplace(symbol, table.value(solver.value(var)));
+	}
+	return result;
+}
@@ -0,0 +1,268 @@
+#include <typecheck/type_manager.hpp>
+#include <typecheck/consistency_report.hpp>
+#include <typecheck/union_find.hpp>
+#include <typecheck/constraint.hpp>
+
+#include <typecheck/protocols/ExpressibleByFloatLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByIntegerLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByDoubleLiteral.hpp>
+
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace typecheck;
+
+namespace {
+	template<typename T>
+	auto LiteralProtocolNames() -> std::set<std::string> {
+		T protocol;
+		std::set<std::string> names;
+		for (const auto& ty : protocol.getPreferredTypes()) {
+			names.insert(ty.raw().name());
+		}
+
+		for (const auto& ty : protocol.getOtherTypes()) {
+			names.insert(ty.raw().name());
+		}
+		return names;
+	}
+
+	auto LiteralNames(const KnownProtocolKind::LiteralProtocol& protocol) -> std::optional<std::set<std::string>> {
+		switch (protocol) {
+		case KnownProtocolKind::ExpressibleByFloat:
+			return LiteralProtocolNames<ExpressibleByFloatLiteral>();
+		case KnownProtocolKind::ExpressibleByDouble:
+			return LiteralProtocolNames<ExpressibleByDoubleLiteral>();
+		case KnownProtocolKind::ExpressibleByInteger:
+			return LiteralProtocolNames<ExpressibleByIntegerLiteral>();
+		case KnownProtocolKind::ExpressibleByArray:
+		case KnownProtocolKind::ExpressibleByBoolean:
+		case KnownProtocolKind::ExpressibleByDictionary:
+		case KnownProtocolKind::ExpressibleByNil:
+		case KnownProtocolKind::ExpressibleByString:
+		default:
+			return std::nullopt;
+		}
+	}
+
+	// Variables known to be equal, plus the equalities that put them there so conflicts can be explained.
+	class EquivalenceClasses {
+	public:
+		struct Restriction {
+			// `nullopt` when nothing restricts the class yet.
+			std::optional<std::set<std::string>> allowed;
+			std::vector<std::pair<std::size_t, Constraint::IDType>> reasons;
+		};
+
+		explicit EquivalenceClasses(std::pmr::memory_resource* resource) : indices(resource), symbols(resource), edges(resource), restrictions(resource) {}
+
+		auto index(const std::string& var) -> std::size_t {
+			const auto it = this->indices.find(var);
+			if (it != this->indices.end()) {
+				return it->second;
+			}
+
+			this->edges.emplace_back();
+			this->symbols.push_back(var);
+			return this->indices.emplace(var, this->classes.add()).first->second;
+		}
+
+		void unite(const std::size_t a, const std::size_t b, const Constraint::IDType id) {
+			this->classes.unite(a, b);
+			this->edges.at(a).emplace_back(b, id);
+			this->edges.at(b).emplace_back(a, id);
+		}
+
+		auto restriction(const std::size_t var) -> Restriction& {
+			return this->restrictions[this->classes.find(var)];
+		}
+
+		auto symbol(const std::size_t var) const -> const std::string& {
+			return this->symbols.at(var);
+		}
+
+		// Adds the equalities connecting `from` and `to` to the report, only used once a conflict is found.
+		void explain(const std::size_t from, const std::size_t to, ConsistencyReport* report) const {
+			std::vector<std::optional<std::pair<std::size_t, Constraint::IDType>>> previous(this->edges.size());
+			std::vector<bool> visited(this->edges.size(), false);
+			std::queue<std::size_t> queue;
+			queue.push(from);
+			visited.at(from) = true;
+			while (!queue.empty() && !visited.at(to)) {
+				const auto curr = queue.front();
+				queue.pop();
+				for (const auto& [next, id] : this->edges.at(curr)) {
+					if (!visited.at(next)) {
+						visited.at(next) = true;
+						previous.at(next) = std::make_pair(curr, id);
+						queue.push(next);
+					}
+				}
+			}
+
+			for (auto curr = to; previous.at(curr).has_value(); curr = previous.at(curr)->first) {
+				report->add_conflicting(previous.at(curr)->second);
+			}
+		}
+
+		void blame(const std::size_t var, const Restriction& restriction, ConsistencyReport* report) const {
+			for (const auto& [reasonVar, id] : restriction.reasons) {
+				report->add_conflicting(id);
+				this->explain(var, reasonVar, report);
+			}
+		}
+
+	private:
+		UnionFind classes;
+		std::pmr::unordered_map<std::string, std::size_t> indices;
+		std::pmr::vector<std::string> symbols;
+		std::pmr::vector<std::pmr::vector<std::pair<std::size_t, Constraint::IDType>>> edges;
+		std::pmr::unordered_map<std::size_t, Restriction> restrictions;
+	};
+}
+
+auto TypeManager::checkConsistency() const -> ConsistencyReport {
+	std::pmr::monotonic_buffer_resource scratch;
+	return this->checkConsistency(this->allConstraints(&scratch), &scratch);
+}
+
+auto TypeManager::checkConsistency(const std::pmr::vector<const Constraint*>& active, std::pmr::memory_resource* resource) const -> ConsistencyReport {
+	ConsistencyReport report;
+	EquivalenceClasses classes(resource);
+
+	std::pmr::set<std::string> registeredNames(resource);
+	for (const auto* layer : this->registries()) {
+		for (const auto& ty : layer->types()) {
+			registeredNames.insert(ty.has_func() ? ty.func().name() : ty.raw().name());
+		}
+	}
+
+	// Merge everything that must be equal first, so restrictions apply to the whole class.
+	for (const auto* constraintPtr : active) {
+		const auto& constraint = *constraintPtr;
+		if (constraint.kind() != Equal || !constraint.has_types()) {
+			continue;
+		}
+
+		const auto& types = constraint.types();
+		if (!types.has_first()) {
+			continue;
+		}
+		const auto first = classes.index(types.first().symbol());
+		if (types.has_second()) {
+			classes.unite(first, classes.index(types.second().symbol()), constraint.id());
+		}
+		if (types.has_third()) {
+			classes.unite(first, classes.index(types.third().symbol()), constraint.id());
+		}
+	}
+
+	auto restrict = [&classes, &report](const std::size_t var, const std::set<std::string>& allowed, const Constraint::IDType id) {
+		auto& restriction = classes.restriction(var);
+		if (!restriction.allowed.has_value()) {
+			restriction.allowed = allowed;
+		} else {
+			std::set<std::string> both;
+			for (const auto& name : allowed) {
+				if (restriction.allowed->find(name) != restriction.allowed->end()) {
+					both.insert(name);
+				}
+			}
+			restriction.allowed = std::move(both);
+		}
+		restriction.reasons.emplace_back(var, id);
+
+		if (restriction.allowed->empty()) {
+			report.set_reason("No type satisfies every constraint on " + classes.symbol(var));
+			classes.blame(var, restriction, &report);
+			return false;
+		}
+		return true;
+	};
+
+	for (const auto* constraintPtr : active) {
+		const auto& constraint = *constraintPtr;
+		if (constraint.has_explicit_() && constraint.explicit_().has_var() && constraint.explicit_().has_type()) {
+			const auto& explicit_ = constraint.explicit_();
+			const auto var = classes.index(explicit_.var().symbol());
+			if (!explicit_.type().has_raw()) {
+				report.set_reason("Cannot bind " + explicit_.var().symbol() + " to a function type");
+				report.add_conflicting(constraint.id());
+				return report;
+			}
+
+			const auto name = explicit_.type().raw().name();
+			if (registeredNames.find(name) == registeredNames.end()) {
+				report.set_reason("Cannot bind " + explicit_.var().symbol() + " to unregistered type " + name);
+				report.add_conflicting(constraint.id());
+				return report;
+			}
+
+			if (!restrict(var, {name}, constraint.id())) {
+				return report;
+			}
+		} else if (constraint.has_conforms() && constraint.conforms().has_type() && constraint.conforms().has_protocol() && constraint.conforms().protocol().has_literal()) {
+			const auto literal = LiteralNames(constraint.conforms().protocol().literal());
+			if (!literal.has_value()) {
+				// `solve` rejects these on its own.
+				continue;
+			}
+
+			std::set<std::string> allowed;
+			for (const auto& name : *literal) {
+				if (registeredNames.find(name) != registeredNames.end()) {
+					allowed.insert(name);
+				}
+			}
+
+			if (!restrict(classes.index(constraint.conforms().type().symbol()), allowed, constraint.id())) {
+				return report;
+			}
+		}
+	}
+
+	// With the classes settled, conversions only need to check a pair of (small) sets.
+	for (const auto* constraintPtr : active) {
+		const auto& constraint = *constraintPtr;
+		if (constraint.kind() != Conversion || !constraint.has_types() || !constraint.types().has_first() || !constraint.types().has_second()) {
+			continue;
+		}
+
+		const auto from = classes.index(constraint.types().first().symbol());
+		const auto to = classes.index(constraint.types().second().symbol());
+		const auto& fromRestriction = classes.restriction(from);
+		const auto& toRestriction = classes.restriction(to);
+		if (!fromRestriction.allowed.has_value() || !toRestriction.allowed.has_value()) {
+			continue;
+		}
+
+		bool possible = false;
+		for (const auto& a : *fromRestriction.allowed) {
+			for (const auto& b : *toRestriction.allowed) {
+				if (a == b || this->isConvertible(a, b)) {
+					possible = true;
+					break;
+				}
+			}
+			if (possible) {
+				break;
+			}
+		}
+
+		if (!possible) {
+			report.set_reason(constraint.types().first().symbol() + " is not convertible to " + constraint.types().second().symbol());
+			report.add_conflicting(constraint.id());
+			classes.blame(from, fromRestriction, &report);
+			classes.blame(to, toRestriction, &report);
+			return report;
+		}
+	}
+
+	return report;
+}
@@ -1,10 +1,10 @@
 #include <typecheck/type_manager.hpp>
 #include <typecheck/debug.hpp>
 #include <typecheck/constraint.hpp>
+#include <typecheck/trace.hpp>
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
-#include <iostream>
-#include <string>
+#include <typecheck/debug_log.hpp>
 #endif
 
 #include <algorithm> // for std::sort
@@ -18,16 +18,6 @@ namespace {
 		constraint.set_id(id);
 		return constraint;
 	}
-
-#ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
-	auto debug_constraint_headers(const Constraint& constraint) -> std::string {
-#ifdef TYPECHECK_PRINT_SHORT_DEBUG
-		return constraint.ShortDebugString();
-#else
-		return constraint.DebugString();
-#endif
-	}
-#endif
 }
 
 auto TypeManager::CreateEqualsConstraint(const TypeVar& t0, const TypeVar& t1) -> Constraint::IDType {
@@ -36,15 +26,15 @@ auto TypeManager::CreateEqualsConstraint(const TypeVar& t0, const TypeVar& t1) -
 	TYPECHECK_ASSERT(!t0.symbol().empty(), "Cannot use empty type when creating constraint.");
 	TYPECHECK_ASSERT(!t1.symbol().empty(), "Cannot use empty type when creating constraint.");
 
-	TYPECHECK_ASSERT(this->registeredTypeVars.find(t0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
-	TYPECHECK_ASSERT(this->registeredTypeVars.find(t1.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+	TYPECHECK_ASSERT(this->hasTypeVar(t0.symbol()), "Must create type var before using.");
+	TYPECHECK_ASSERT(this->hasTypeVar(t1.symbol()), "Must create type var before using.");
 
 	constraint.mutable_types()->mutable_first()->CopyFrom(t0);
 	constraint.mutable_types()->mutable_second()->CopyFrom(t1);
 
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
-    std::cout << debug_constraint_headers(constraint) << std::endl;
+    DebugLog::record(DebugLog::Event::CreateConstraint, constraint);
 #endif
 
 	this->constraints.emplace_back(constraint);
@@ -55,14 +45,14 @@ auto TypeManager::CreateLiteralConformsToConstraint(const TypeVar& t0, const Kno
 	auto constraint = getNewBlankConstraint(ConstraintKind::ConformsTo, this->constraint_generator.next_id());
 
 	TYPECHECK_ASSERT(!t0.symbol().empty(), "Cannot use empty type when creating constraint.");
-	TYPECHECK_ASSERT(this->registeredTypeVars.find(t0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+	TYPECHECK_ASSERT(this->hasTypeVar(t0.symbol()), "Must create type var before using.");
 
 	constraint.mutable_conforms()->mutable_type()->CopyFrom(t0);
 	constraint.mutable_conforms()->mutable_protocol()->set_literal(protocol);
 
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
-    std::cout << debug_constraint_headers(constraint) << std::endl;
+    DebugLog::record(DebugLog::Event::CreateConstraint, constraint);
 #endif
 
 	this->constraints.emplace_back(constraint);
@@ -73,16 +63,16 @@ auto TypeManager::CreateConvertibleConstraint(const TypeVar& T0, const TypeVar&
     auto constraint = getNewBlankConstraint(ConstraintKind::Conversion, this->constraint_generator.next_id());
 
     TYPECHECK_ASSERT(!T0.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T0.symbol()), "Must create type var before using.");
 
     TYPECHECK_ASSERT(!T1.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T1.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T1.symbol()), "Must create type var before using.");
 
     constraint.mutable_types()->mutable_first()->CopyFrom(T0);
     constraint.mutable_types()->mutable_second()->CopyFrom(T1);
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
-    std::cout << debug_constraint_headers(constraint) << std::endl;
+    DebugLog::record(DebugLog::Event::CreateConstraint, constraint);
 #endif
 
     this->constraints.emplace_back(constraint);
@@ -90,6 +80,7 @@ auto TypeManager::CreateConvertibleConstraint(const TypeVar& T0, const TypeVar&
 }
 
 auto TypeManager::CreateApplicableFunctionConstraint(const Constraint::IDType& functionid, const std::vector<Type>& args, const Type& return_type) -> Constraint::IDType {
+    TYPECHECK_TRACE_SPAN("create applicable function");
     const auto returnVar = this->CreateTypeVar();
     std::vector<TypeVar> argVars;
     for (std::size_t i = 0; i < args.size(); ++i) {
@@ -120,7 +111,7 @@ auto TypeManager::CreateApplicableFunctionConstraint(const Constraint::IDType& f
 auto TypeManager::CreateApplicableFunctionConstraint(const Constraint::IDType& functionid, const FunctionVar& type) -> Constraint::IDType {
     TYPECHECK_ASSERT(type.id() == functionid, "Function type ID should match function id and be set.");
 
-    this->functions.push_back(type);
+    this->registry.addFunction(type);
     return type.id();
 }
 
@@ -128,22 +119,22 @@ auto TypeManager::CreateBindFunctionConstraint(const Constraint::IDType& functio
     auto constraint = getNewBlankConstraint(ConstraintKind::BindOverload, this->constraint_generator.next_id());
 
     TYPECHECK_ASSERT(!T0.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T0.symbol()), "Must create type var before using.");
     constraint.mutable_overload()->mutable_type()->CopyFrom(T0);
     constraint.mutable_overload()->set_functionid(functionid);
 
     for (auto& arg : args) {
         TYPECHECK_ASSERT(!arg.symbol().empty(), "Cannot use empty type when creating constraint.");
-        TYPECHECK_ASSERT(this->registeredTypeVars.find(arg.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+        TYPECHECK_ASSERT(this->hasTypeVar(arg.symbol()), "Must create type var before using.");
         constraint.mutable_overload()->add_argvars()->CopyFrom(arg);
     }
 
     TYPECHECK_ASSERT(!returnType.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(returnType.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(this->hasTypeVar(returnType.symbol()), "Must create type var before using.");
     constraint.mutable_overload()->mutable_returnvar()->CopyFrom(returnType);
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
-    std::cout << debug_constraint_headers(constraint) << std::endl;
+    DebugLog::record(DebugLog::Event::CreateConstraint, constraint);
 #endif
 
     this->constraints.emplace_back(constraint);
@@ -154,14 +145,14 @@ auto TypeManager::CreateBindToConstraint(const TypeVar& T0, const Type& type) ->
     auto constraint = getNewBlankConstraint(ConstraintKind::Bind, this->constraint_generator.next_id());
 
     TYPECHECK_ASSERT(!T0.symbol().empty(), "Cannot use empty type when creating constraint.");
-    TYPECHECK_ASSERT(this->registeredTypeVars.find(T0.symbol()) != this->registeredTypeVars.end(), "Must create type var before using.");
+    TYPECHECK_ASSERT(this->hasTypeVar(T0.symbol()), "Must create type var before using.");
     TYPECHECK_ASSERT(type.has_raw() || type.has_func(), "Must insert valid type.");
 
     constraint.mutable_explicit_()->mutable_var()->CopyFrom(T0);
     constraint.mutable_explicit_()->mutable_type()->CopyFrom(type);
 
 #ifdef TYPECHECK_PRINT_DEBUG_CONSTRAINTS
-    std::cout << debug_constraint_headers(constraint) << std::endl;
+    DebugLog::record(DebugLog::Event::CreateConstraint, constraint);
 #endif
 
     this->constraints.emplace_back(constraint);
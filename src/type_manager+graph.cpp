@@ -0,0 +1,114 @@
+#include <typecheck/type_manager.hpp>
+#include <typecheck/constraint_graph.hpp>
+
+#include <typecheck/protocols/ExpressibleByFloatLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByIntegerLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByDoubleLiteral.hpp>
+
+#include <memory_resource>
+#include <string>
+
+using namespace typecheck;
+
+namespace {
+	template<typename T>
+	auto LiteralDomainSize() -> std::size_t {
+		T protocol;
+		return protocol.getPreferredTypes().size() + protocol.getOtherTypes().size();
+	}
+
+	auto LiteralDomainSize(const KnownProtocolKind& protocol, const std::size_t fallback) -> std::size_t {
+		if (!protocol.has_literal()) {
+			return fallback;
+		}
+
+		switch (protocol.literal()) {
+		case KnownProtocolKind::ExpressibleByFloat:
+			return LiteralDomainSize<ExpressibleByFloatLiteral>();
+		case KnownProtocolKind::ExpressibleByDouble:
+			return LiteralDomainSize<ExpressibleByDoubleLiteral>();
+		case KnownProtocolKind::ExpressibleByInteger:
+			return LiteralDomainSize<ExpressibleByIntegerLiteral>();
+		case KnownProtocolKind::ExpressibleByArray:
+		case KnownProtocolKind::ExpressibleByBoolean:
+		case KnownProtocolKind::ExpressibleByDictionary:
+		case KnownProtocolKind::ExpressibleByNil:
+		case KnownProtocolKind::ExpressibleByString:
+			break;
+		}
+		return fallback;
+	}
+}
+
+auto TypeManager::getConstraintGraph() const -> ConstraintGraph {
+	// Same domain `solve` gives every variable, before constraints narrow it.
+	std::size_t varDomain = 0;
+	for (const auto* layer : this->registries()) {
+		varDomain += layer->types().size() + layer->functions().size();
+	}
+
+	// Definitions with concrete types from the shared registry only have one choice.
+	auto definition_domain = [this, varDomain](const TypeVar& var) -> std::size_t {
+		return this->shared->hasBoundType(var.symbol()) ? 1 : varDomain;
+	};
+
+	std::pmr::monotonic_buffer_resource scratch;
+	const auto all = this->allConstraints(&scratch);
+	const auto candidates = this->findOverloadCandidates(all, &scratch);
+	ConstraintGraph graph;
+	for (const auto* constraintPtr : all) {
+		const auto& constraint = *constraintPtr;
+		auto* node = graph.add_constraint(constraint.id(), constraint.kind());
+		if (this->detailedStats) {
+			const auto it = this->stats.evaluations.find(constraint.id());
+			node->evaluations = it == this->stats.evaluations.end() ? 0 : it->second;
+		}
+
+		if (constraint.has_types()) {
+			const auto& vars = constraint.types();
+			if (vars.has_first()) {
+				node->variables.push_back(graph.add_variable(vars.first().symbol(), varDomain));
+			}
+			if (vars.has_second()) {
+				node->variables.push_back(graph.add_variable(vars.second().symbol(), varDomain));
+			}
+			if (vars.has_third()) {
+				node->variables.push_back(graph.add_variable(vars.third().symbol(), varDomain));
+			}
+		} else if (constraint.has_conforms()) {
+			const auto& conforms = constraint.conforms();
+			if (conforms.has_type()) {
+				const auto domain = conforms.has_protocol() ? LiteralDomainSize(conforms.protocol(), varDomain) : varDomain;
+				node->variables.push_back(graph.add_variable(conforms.type().symbol(), domain));
+			}
+		} else if (constraint.has_explicit_()) {
+			const auto& explicit_ = constraint.explicit_();
+			if (explicit_.has_var()) {
+				node->variables.push_back(graph.add_variable(explicit_.var().symbol(), explicit_.has_type() ? 1 : varDomain));
+			}
+		} else if (constraint.has_overload()) {
+			const auto& overload = constraint.overload();
+			const auto it = candidates.find(constraint.id());
+			if (overload.has_type()) {
+				node->variables.push_back(graph.add_variable(overload.type().symbol(), it == candidates.end() ? 0 : it->second.size()));
+			}
+			node->variables.push_back(graph.add_variable(overload.returnvar().symbol(), varDomain));
+			for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+				node->variables.push_back(graph.add_variable(overload.argvars(i).symbol(), varDomain));
+			}
+
+			// `solve` ties the call to the variables of every candidate definition, so calls of the same function are joined through them.
+			if (it != candidates.end()) {
+				for (const auto& func : it->second) {
+					node->variables.push_back(graph.add_variable(func.returnvar().symbol(), definition_domain(func.returnvar())));
+					for (const auto& arg : func.args()) {
+						node->variables.push_back(graph.add_variable(arg.symbol(), definition_domain(arg)));
+					}
+				}
+			}
+		}
+	}
+
+	graph.finalize();
+	return graph;
+}
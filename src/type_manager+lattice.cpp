@@ -0,0 +1,485 @@
+#include <typecheck/type_manager.hpp>
+#include <typecheck/constraint.hpp>
+#include <typecheck/function_var.hpp>
+#include <typecheck/union_find.hpp>
+
+#include <typecheck/protocols/ExpressibleByFloatLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByIntegerLiteral.hpp>
+#include <typecheck/protocols/ExpressibleByDoubleLiteral.hpp>
+
+#include <algorithm>  // for find, remove_if
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace typecheck;
+
+namespace {
+	using ValueID = std::uint32_t;
+	constexpr ValueID NO_VALUE = std::numeric_limits<ValueID>::max();
+
+	// Looking for the least type is quadratic, beyond this just take the first.
+	constexpr std::size_t LEAST_TYPE_LIMIT = 64;
+
+	struct Literal {
+		std::vector<std::string> allowed;
+		std::string preferred;
+	};
+
+	template<typename T>
+	auto LiteralTypes() -> Literal {
+		T protocol;
+		Literal literal;
+		for (const auto& ty : protocol.getPreferredTypes()) {
+			literal.allowed.push_back(ty.raw().name());
+		}
+		for (const auto& ty : protocol.getOtherTypes()) {
+			literal.allowed.push_back(ty.raw().name());
+		}
+		literal.preferred = literal.allowed.front();
+		return literal;
+	}
+
+	auto LiteralTypes(const KnownProtocolKind& protocol) -> std::optional<Literal> {
+		if (!protocol.has_literal()) {
+			return std::nullopt;
+		}
+
+		switch (protocol.literal()) {
+		case KnownProtocolKind::ExpressibleByFloat:
+			return LiteralTypes<ExpressibleByFloatLiteral>();
+		case KnownProtocolKind::ExpressibleByDouble:
+			return LiteralTypes<ExpressibleByDoubleLiteral>();
+		case KnownProtocolKind::ExpressibleByInteger:
+			return LiteralTypes<ExpressibleByIntegerLiteral>();
+		case KnownProtocolKind::ExpressibleByArray:
+		case KnownProtocolKind::ExpressibleByBoolean:
+		case KnownProtocolKind::ExpressibleByDictionary:
+		case KnownProtocolKind::ExpressibleByNil:
+		case KnownProtocolKind::ExpressibleByString:
+			break;
+		}
+		return std::nullopt;
+	}
+
+	// Variables that must be equal share a class, each class has one type.
+	struct TypeClass {
+		// `nullopt` while any registered type will do, otherwise in registration order.
+		std::optional<std::pmr::vector<ValueID>> domain;
+
+		// Preferred type of each literal in the class, the search pays 1 for every literal not given its own.
+		std::pmr::vector<ValueID> preferred;
+
+		// Conversions to and from other classes.
+		std::pmr::vector<std::size_t> to;
+		std::pmr::vector<std::size_t> from;
+
+		ValueID value = NO_VALUE;
+
+		// Tried before the least type, when it's just as cheap.
+		ValueID hint = NO_VALUE;
+	};
+}
+
+auto TypeManager::solveLattice(const std::pmr::vector<const Constraint*>& active, const std::pmr::vector<const Constraint*>& dropped, const OverloadCandidates& overloads, const Hints& hints, ConstraintPass* pass, std::pmr::memory_resource* resource) -> FastPath {
+	// Values are the same as the search would use for a variable, without the function overloads it can't bind here.
+	std::pmr::vector<const std::string*> values(resource);
+	std::pmr::unordered_map<std::string_view, ValueID> valueIDs(resource);
+	for (const auto* layer : this->registries()) {
+		for (const auto& ty : layer->types()) {
+			const auto& name = ty.has_func() ? ty.func().name() : ty.raw().name();
+			if (valueIDs.emplace(name, static_cast<ValueID>(values.size())).second) {
+				values.push_back(&name);
+			}
+		}
+	}
+
+	auto value_id = [&valueIDs](std::string_view name) {
+		const auto it = valueIDs.find(name);
+		return it == valueIDs.end() ? NO_VALUE : it->second;
+	};
+
+	UnionFind sets;
+	std::pmr::unordered_map<std::string_view, std::size_t> vars(resource);
+	std::pmr::vector<std::string_view> symbols(resource);
+	auto var_index = [&sets, &vars, &symbols](std::string_view symbol) {
+		const auto [it, inserted] = vars.emplace(symbol, symbols.size());
+		if (inserted) {
+			symbols.push_back(symbol);
+			sets.add();
+		}
+		return it->second;
+	};
+
+	// Overloads with only one choice, unified with their type variable.
+	std::pmr::deque<FunctionVar> functions(resource);
+	std::pmr::vector<std::pair<std::string_view, const FunctionVar*>> bindings(resource);
+	bool hasConversions = false;
+
+	// Only conversions, equalities, literals, binds to a registered type and single overloads are handled here.
+	for (const auto* constraint : active) {
+		if (constraint->has_types() && (constraint->kind() == Equal || constraint->kind() == Conversion)) {
+			const auto& typeVars = constraint->types();
+			if (!typeVars.has_first() || !typeVars.has_second() || (constraint->kind() == Conversion && typeVars.has_third())) {
+				return FastPath::Fallback;
+			}
+
+			const auto first = var_index(typeVars.first().symbol());
+			const auto second = var_index(typeVars.second().symbol());
+			hasConversions |= constraint->kind() == Conversion;
+			if (constraint->kind() == Equal) {
+				sets.unite(first, second);
+				if (typeVars.has_third()) {
+					sets.unite(first, var_index(typeVars.third().symbol()));
+				}
+			}
+		} else if (constraint->has_conforms()) {
+			const auto& conforms = constraint->conforms();
+			if (!conforms.has_type() || !conforms.has_protocol() || !LiteralTypes(conforms.protocol()).has_value()) {
+				return FastPath::Fallback;
+			}
+			var_index(conforms.type().symbol());
+		} else if (constraint->has_explicit_()) {
+			const auto& explicit_ = constraint->explicit_();
+			if (!explicit_.has_var() || !explicit_.has_type() || !explicit_.type().has_raw()) {
+				return FastPath::Fallback;
+			}
+			var_index(explicit_.var().symbol());
+		} else if (constraint->has_overload()) {
+			const auto& overload = constraint->overload();
+			const auto& family = overloads.at(constraint->id());
+			if (!overload.has_type() || family.size() != 1) {
+				// A real choice to make (or none at all), leave it to the search.
+				return FastPath::Fallback;
+			}
+
+			const auto& func = functions.emplace_back(family.front());
+			bindings.emplace_back(overload.type().symbol(), &func);
+			sets.unite(var_index(overload.returnvar().symbol()), var_index(func.returnvar().symbol()));
+			for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+				sets.unite(var_index(overload.argvars(i).symbol()), var_index(func.args().at(i).symbol()));
+			}
+		} else {
+			return FastPath::Fallback;
+		}
+	}
+
+	// The type variable of an overload holds a function rather than a registered type, so can't be in a class.
+	std::pmr::unordered_set<std::string_view> bound(resource);
+	for (const auto& [symbol, func] : bindings) {
+		if (vars.find(symbol) != vars.end() || !bound.insert(symbol).second) {
+			return FastPath::Fallback;
+		}
+	}
+
+	for (const auto* constraint : dropped) {
+		if (constraint->has_types() && constraint->types().has_first()) {
+			var_index(constraint->types().first().symbol());
+		}
+	}
+
+	std::pmr::vector<TypeClass> classes(resource);
+	std::pmr::unordered_map<std::size_t, std::size_t> classIndices(resource);
+	std::pmr::vector<std::size_t> varClass(resource);
+	for (std::size_t i = 0; i < symbols.size(); ++i) {
+		const auto [it, inserted] = classIndices.emplace(sets.find(i), classes.size());
+		if (inserted) {
+			classes.push_back(TypeClass{std::nullopt, std::pmr::vector<ValueID>(resource), std::pmr::vector<std::size_t>(resource), std::pmr::vector<std::size_t>(resource), NO_VALUE, NO_VALUE});
+		}
+		varClass.push_back(it->second);
+
+		// The first hinted variable of a class decides its hint.
+		const auto hint = hints.find(symbols.at(i));
+		auto& typeClass = classes.at(it->second);
+		if (hint != hints.end() && typeClass.hint == NO_VALUE) {
+			typeClass.hint = value_id(hint->second);
+		}
+	}
+
+	auto restrict = [&classes](const std::size_t c, const std::pmr::vector<ValueID>& allowed) {
+		auto& domain = classes.at(c).domain;
+		if (!domain.has_value()) {
+			domain.emplace(allowed.begin(), allowed.end(), allowed.get_allocator());
+		} else {
+			domain->erase(std::remove_if(domain->begin(), domain->end(), [&allowed](const ValueID v) {
+				return std::find(allowed.begin(), allowed.end(), v) == allowed.end();
+			}), domain->end());
+		}
+		return !domain->empty();
+	};
+
+	for (const auto* constraint : active) {
+		if (constraint->has_types() && constraint->kind() == Conversion) {
+			const auto from = varClass.at(vars.at(constraint->types().first().symbol()));
+			const auto to = varClass.at(vars.at(constraint->types().second().symbol()));
+			if (from != to) {
+				classes.at(from).to.push_back(to);
+				classes.at(to).from.push_back(from);
+			}
+		} else if (constraint->has_conforms()) {
+			const auto c = varClass.at(vars.at(constraint->conforms().type().symbol()));
+			const auto literal = *LiteralTypes(constraint->conforms().protocol());
+			std::pmr::vector<ValueID> allowed(resource);
+			for (const auto& name : literal.allowed) {
+				if (const auto id = value_id(name); id != NO_VALUE) {
+					allowed.push_back(id);
+				}
+			}
+			classes.at(c).preferred.push_back(value_id(literal.preferred));
+			if (!restrict(c, allowed)) {
+				return FastPath::Unsatisfiable;
+			}
+		} else if (constraint->has_explicit_()) {
+			const auto c = varClass.at(vars.at(constraint->explicit_().var().symbol()));
+			const auto id = value_id(constraint->explicit_().type().raw().name());
+			if (id == NO_VALUE || !restrict(c, std::pmr::vector<ValueID>({id}, resource))) {
+				return FastPath::Unsatisfiable;
+			}
+		}
+	}
+
+	// Shared overloads have concrete types, so there is only one choice.
+	for (const auto& func : functions) {
+		auto bind_shared = [&](const TypeVar& var) {
+			if (!this->shared->hasBoundType(var.symbol())) {
+				return true;
+			}
+
+			const auto& type = this->shared->getBoundType(var.symbol());
+			const auto id = value_id(type.has_func() ? type.func().name() : type.raw().name());
+			return id != NO_VALUE && restrict(varClass.at(vars.at(var.symbol())), std::pmr::vector<ValueID>({id}, resource));
+		};
+
+		if (!bind_shared(func.returnvar())) {
+			return FastPath::Fallback;
+		}
+		for (const auto& arg : func.args()) {
+			if (!bind_shared(arg)) {
+				return FastPath::Fallback;
+			}
+		}
+	}
+
+	auto converts = [this, &values](const ValueID a, const ValueID b) {
+		return a == b || this->isConvertible(*values.at(a), *values.at(b));
+	};
+
+	// Keeps the values of `c` with some value of `other` on the other side of the conversion.
+	// A class any type will do for supports everything (every type converts to itself), so is never revised against.
+	auto revise = [&classes, &values, &converts, resource](const std::size_t c, const std::size_t other, const bool forward) {
+		const auto& otherDomain = classes.at(other).domain;
+		if (!otherDomain.has_value()) {
+			return false;
+		}
+
+		auto& domain = classes.at(c).domain;
+		if (!domain.has_value()) {
+			domain.emplace(resource);
+			domain->reserve(values.size());
+			for (ValueID v = 0; v < values.size(); ++v) {
+				domain->push_back(v);
+			}
+		}
+
+		const auto before = domain->size();
+		domain->erase(std::remove_if(domain->begin(), domain->end(), [&](const ValueID v) {
+			for (const auto w : *otherDomain) {
+				if (forward ? converts(v, w) : converts(w, v)) {
+					return false;
+				}
+			}
+			return true;
+		}), domain->end());
+		return domain->size() != before;
+	};
+
+	// Arc consistency over the conversions, narrowing each class to the types that can still take part.
+	std::queue<std::size_t> queue;
+	std::pmr::vector<bool> queued(classes.size(), true, resource);
+	for (std::size_t c = 0; c < classes.size(); ++c) {
+		queue.push(c);
+	}
+	while (!queue.empty()) {
+		const auto other = queue.front();
+		queue.pop();
+		queued.at(other) = false;
+
+		auto visit = [&](const std::size_t c, const bool forward) {
+			if (revise(c, other, forward)) {
+				if (classes.at(c).domain->empty()) {
+					return false;
+				}
+				if (!queued.at(c)) {
+					queued.at(c) = true;
+					queue.push(c);
+				}
+			}
+			return true;
+		};
+
+		for (const auto c : classes.at(other).from) {
+			if (!visit(c, true)) {
+				return FastPath::Unsatisfiable;
+			}
+		}
+		for (const auto c : classes.at(other).to) {
+			if (!visit(c, false)) {
+				return FastPath::Unsatisfiable;
+			}
+		}
+	}
+
+	auto cost = [&classes](const std::size_t c, const ValueID v) {
+		std::size_t total = 0;
+		for (const auto preferred : classes.at(c).preferred) {
+			total += preferred != v;
+		}
+		return total;
+	};
+
+	// No solution can do better than every class getting its cheapest type.
+	std::size_t lowerBound = 0;
+	for (std::size_t c = 0; c < classes.size(); ++c) {
+		if (classes.at(c).domain.has_value() && !classes.at(c).preferred.empty()) {
+			auto best = std::numeric_limits<std::size_t>::max();
+			for (const auto v : *classes.at(c).domain) {
+				best = std::min(best, cost(c, v));
+			}
+			lowerBound += best;
+		}
+	}
+
+	// Assign along the conversions, so each class follows the ones converting into it.
+	std::pmr::vector<std::size_t> order(resource);
+	{
+		std::pmr::vector<std::size_t> remaining(classes.size(), 0, resource);
+		std::queue<std::size_t> ready;
+		for (std::size_t c = 0; c < classes.size(); ++c) {
+			remaining.at(c) = classes.at(c).from.size();
+			if (remaining.at(c) == 0) {
+				ready.push(c);
+			}
+		}
+		std::pmr::vector<bool> placed(classes.size(), false, resource);
+		while (order.size() < classes.size()) {
+			if (ready.empty()) {
+				// A cycle, break it at the oldest class left.
+				for (std::size_t c = 0; c < classes.size(); ++c) {
+					if (!placed.at(c) && remaining.at(c) > 0) {
+						remaining.at(c) = 0;
+						ready.push(c);
+						break;
+					}
+				}
+			}
+
+			const auto c = ready.front();
+			ready.pop();
+			if (placed.at(c)) {
+				continue;
+			}
+			placed.at(c) = true;
+			order.push_back(c);
+			for (const auto next : classes.at(c).to) {
+				if (remaining.at(next) > 0 && --remaining.at(next) == 0) {
+					ready.push(next);
+				}
+			}
+		}
+	}
+
+	std::size_t total = 0;
+	std::pmr::vector<ValueID> candidates(resource);
+	for (const auto c : order) {
+		auto& typeClass = classes.at(c);
+		candidates.clear();
+		auto consider = [&](const ValueID v) {
+			for (const auto from : typeClass.from) {
+				if (classes.at(from).value != NO_VALUE && !converts(classes.at(from).value, v)) {
+					return;
+				}
+			}
+			for (const auto to : typeClass.to) {
+				if (classes.at(to).value != NO_VALUE && !converts(v, classes.at(to).value)) {
+					return;
+				}
+			}
+			candidates.push_back(v);
+		};
+
+		if (typeClass.domain.has_value()) {
+			for (const auto v : *typeClass.domain) {
+				consider(v);
+			}
+		} else {
+			for (ValueID v = 0; v < values.size(); ++v) {
+				consider(v);
+			}
+		}
+
+		if (candidates.empty()) {
+			// Choosing greedily painted us into a corner, leave it to the search.
+			return FastPath::Fallback;
+		}
+
+		// The cheapest, and of those the least type: one converting to all of the others.
+		auto bestCost = std::numeric_limits<std::size_t>::max();
+		for (const auto v : candidates) {
+			bestCost = std::min(bestCost, cost(c, v));
+		}
+		candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](const ValueID v) {
+			return cost(c, v) != bestCost;
+		}), candidates.end());
+
+		typeClass.value = candidates.front();
+		if (typeClass.hint != NO_VALUE && std::find(candidates.begin(), candidates.end(), typeClass.hint) != candidates.end()) {
+			typeClass.value = typeClass.hint;
+		} else if (candidates.size() <= LEAST_TYPE_LIMIT) {
+			for (const auto v : candidates) {
+				const auto least = std::all_of(candidates.begin(), candidates.end(), [&](const ValueID w) {
+					return converts(v, w);
+				});
+				if (least) {
+					typeClass.value = v;
+					break;
+				}
+			}
+		}
+		total += bestCost;
+	}
+
+	if (total != lowerBound) {
+		// Not provably as good as the search would find.
+		return FastPath::Fallback;
+	}
+
+	auto resolved = [&](const TypeVar& var) {
+		return this->typeFactory.raw(*values.at(classes.at(varClass.at(vars.at(var.symbol()))).value));
+	};
+
+	for (std::size_t i = 0; i < symbols.size(); ++i) {
+		const auto value = classes.at(varClass.at(i)).value;
+		pass->setResolvedType(std::string(symbols.at(i)), this->typeFactory.raw(*values.at(value)).type());
+	}
+	for (const auto& [symbol, func] : bindings) {
+		std::vector<TypeFactory::Ref> args;
+		for (const auto& arg : func->args()) {
+			args.push_back(resolved(arg));
+		}
+		pass->setResolvedType(std::string(symbol), this->typeFactory.function(func->name(), func->id(), args, resolved(func->returnvar())).type());
+	}
+
+	// Without conversions, every class was settled by unification alone.
+	this->stats.path = hasConversions ? SolveStats::Lattice : SolveStats::Unification;
+	this->stats.variables = symbols.size() + bindings.size();
+	return FastPath::Solved;
+}
@@ -0,0 +1,30 @@
+#include <typecheck/type_manager.hpp>
+#include <typecheck/memory_usage.hpp>
+
+using namespace typecheck;
+
+auto TypeManager::memoryUsage() const -> MemoryUsage {
+	MemoryUsage usage;
+	usage.registry = this->registry.typesMemoryUsage() + heap::bytes(this->registryLayers);
+	usage.functions = this->registry.functionsMemoryUsage();
+	usage.constraints = heap::bytes(this->constraints);
+	usage.typeVars = heap::bytes(this->registeredTypeVars);
+
+	// Everything a solve allocates comes from the arena, which draws from the pool.
+	usage.solverWorkspace = this->workspace.allocated();
+
+	usage.result = this->typeFactory.memoryUsage() + heap::bytes(this->conflict.conflicting()) + heap::bytes(this->conflict.reason()) + heap::bytes(this->stats.evaluations);
+	if (this->lastSolution.has_value()) {
+		usage.result += heap::bytes(this->lastSolution->getResolvedTypes());
+	}
+#ifdef TYPECHECK_ENABLE_PROFILER
+	usage.result += this->profile.size() * (sizeof(Constraint::IDType) + sizeof(ConstraintProfile::Entry) + 2 * sizeof(void*));
+#endif
+
+	for (const auto* layer = this->frozen.get(); layer != nullptr; layer = layer->parent.get()) {
+		usage.shared += sizeof(Frozen) + layer->registry.typesMemoryUsage() + layer->registry.functionsMemoryUsage() + heap::bytes(layer->constraints) + heap::bytes(layer->typeVars);
+	}
+	usage.shared += this->shared->typesMemoryUsage() + this->shared->functionsMemoryUsage();
+
+	return usage;
+}
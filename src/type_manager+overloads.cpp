@@ -0,0 +1,88 @@
+#include <typecheck/type_manager.hpp>
+#include <typecheck/constraint.hpp>
+#include <typecheck/function_var.hpp>
+
+#include <map>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace typecheck;
+
+auto TypeManager::findOverloadCandidates(const std::pmr::vector<const Constraint*>& active, std::pmr::memory_resource* resource, std::size_t* pruned) const -> OverloadCandidates {
+	OverloadCandidates candidates(resource);
+
+	// Types already known before searching, from binds in this system or the shared registry.
+	std::pmr::unordered_map<std::string_view, std::string_view> bound(resource);
+	bool hasOverloads = false;
+	for (const auto* constraint : active) {
+		if (constraint->has_explicit_() && constraint->explicit_().has_var() && constraint->explicit_().type().has_raw()) {
+			bound.emplace(constraint->explicit_().var().symbol(), constraint->explicit_().type().raw().name());
+		}
+		hasOverloads |= constraint->has_overload();
+	}
+	if (!hasOverloads) {
+		return candidates;
+	}
+
+	auto bound_type = [this, &bound](const TypeVar& var) -> std::string_view {
+		const auto it = bound.find(var.symbol());
+		if (it != bound.end()) {
+			return it->second;
+		}
+		if (this->shared->hasBoundType(var.symbol())) {
+			const auto& type = this->shared->getBoundType(var.symbol());
+			return type.has_func() ? type.func().name() : type.raw().name();
+		}
+		return {};
+	};
+
+	// Two variables bound to different types can never be equal.
+	auto conflicts = [&bound_type](const TypeVar& call, const TypeVar& definition) {
+		const auto callType = bound_type(call);
+		const auto definitionType = bound_type(definition);
+		return !callType.empty() && !definitionType.empty() && callType != definitionType;
+	};
+
+	// Overloads of each function by number of args, so a call only looks at those it could match.
+	std::pmr::unordered_map<Constraint::IDType, std::pmr::map<std::size_t, std::vector<FunctionVar>>> index(resource);
+	std::pmr::unordered_map<Constraint::IDType, std::size_t> familySize(resource);
+	for (const auto* layer : this->registries()) {
+		for (const auto& func : layer->functions()) {
+			index[func.id()][func.args().size()].push_back(func);
+			++familySize[func.id()];
+		}
+	}
+
+	for (const auto* constraint : active) {
+		if (!constraint->has_overload()) {
+			continue;
+		}
+
+		const auto& overload = constraint->overload();
+		auto& possible = candidates[constraint->id()];
+		const auto family = index.find(overload.functionid());
+		if (family == index.end()) {
+			continue;
+		}
+
+		const auto sameArity = family->second.find(overload.argvars_size());
+		if (sameArity != family->second.end()) {
+			for (const auto& func : sameArity->second) {
+				bool matches = !conflicts(overload.returnvar(), func.returnvar());
+				for (std::size_t i = 0; i < overload.argvars_size() && matches; ++i) {
+					matches = !conflicts(overload.argvars(i), func.args().at(i));
+				}
+				if (matches) {
+					possible.push_back(func);
+				}
+			}
+		}
+		if (pruned != nullptr) {
+			*pruned += familySize.at(overload.functionid()) - possible.size();
+		}
+	}
+
+	return candidates;
+}
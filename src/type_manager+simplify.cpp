@@ -0,0 +1,97 @@
+#include <typecheck/type_manager.hpp>
+#include <typecheck/constraint.hpp>
+
+#include <algorithm>  // for sort, unique
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+using namespace typecheck;
+
+namespace {
+	// Separates the parts of a key, symbols and type names never contain it.
+	constexpr char KEY_SEPARATOR = '\0';
+
+	void AppendKeyPart(std::pmr::string& key, std::string_view part) {
+		key.append(part.data(), part.size());
+		key.push_back(KEY_SEPARATOR);
+	}
+
+	// Returns true if the constraint always holds, otherwise fills in `key` so equivalent constraints have equal keys.
+	auto Normalize(const Constraint& constraint, std::pmr::string& key) -> bool {
+		key.push_back(static_cast<char>('a' + constraint.kind()));
+		if (constraint.has_types()) {
+			const auto& types = constraint.types();
+			std::vector<std::string_view> symbols;
+			if (types.has_first()) {
+				symbols.push_back(types.first().symbol());
+			}
+			if (types.has_second()) {
+				symbols.push_back(types.second().symbol());
+			}
+			if (types.has_third()) {
+				symbols.push_back(types.third().symbol());
+			}
+
+			if (constraint.kind() == Equal) {
+				// Order doesn't matter, neither does repeating a variable.
+				std::sort(symbols.begin(), symbols.end());
+				symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+				if (symbols.size() == 1) {
+					return true;
+				}
+			} else if (constraint.kind() == Conversion && symbols.size() == 2 && symbols.front() == symbols.back()) {
+				// Every type converts to itself.
+				return true;
+			}
+
+			for (const auto& symbol : symbols) {
+				AppendKeyPart(key, symbol);
+			}
+		} else if (constraint.has_conforms()) {
+			const auto& conforms = constraint.conforms();
+			AppendKeyPart(key, conforms.has_type() ? std::string_view(conforms.type().symbol()) : std::string_view());
+			AppendKeyPart(key, conforms.has_protocol() ? conforms.protocol().ShortDebugString() : std::string());
+		} else if (constraint.has_explicit_()) {
+			const auto& explicit_ = constraint.explicit_();
+			AppendKeyPart(key, explicit_.has_var() ? std::string_view(explicit_.var().symbol()) : std::string_view());
+			if (explicit_.has_type() && explicit_.type().has_raw()) {
+				AppendKeyPart(key, explicit_.type().raw().name());
+			} else {
+				AppendKeyPart(key, explicit_.has_type() ? explicit_.type().ShortDebugString() : std::string());
+			}
+		} else if (constraint.has_overload()) {
+			const auto& overload = constraint.overload();
+			AppendKeyPart(key, std::to_string(overload.functionid()));
+			AppendKeyPart(key, overload.has_type() ? std::string_view(overload.type().symbol()) : std::string_view());
+			AppendKeyPart(key, overload.returnvar().symbol());
+			for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+				AppendKeyPart(key, overload.argvars(i).symbol());
+			}
+		} else {
+			// Unknown, keep it so `solve` can report it.
+			AppendKeyPart(key, std::to_string(constraint.id()));
+		}
+		return false;
+	}
+}
+
+auto TypeManager::simplifyConstraints(const std::pmr::vector<const Constraint*>& active, std::pmr::memory_resource* resource) const -> SimplifiedConstraints {
+	SimplifiedConstraints simplified{std::pmr::vector<const Constraint*>(resource), std::pmr::vector<const Constraint*>(resource)};
+	simplified.kept.reserve(active.size());
+
+	// Bind constraints on the same variable merge here too, a conflicting pair has different keys (and `checkConsistency` reports it).
+	std::pmr::unordered_set<std::pmr::string> seen(resource);
+	seen.reserve(active.size());
+	for (const auto* constraint : active) {
+		std::pmr::string key(resource);
+		if (Normalize(*constraint, key) || !seen.insert(std::move(key)).second) {
+			simplified.dropped.push_back(constraint);
+		} else {
+			simplified.kept.push_back(constraint);
+		}
+	}
+	return simplified;
+}
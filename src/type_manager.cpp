@@ -2,7 +2,10 @@
 #include <typecheck/constraint.hpp>           // for ConstraintKind
 #include <typecheck/generic_type_generator.hpp>       // for GenericTypeGene...
 #include <typecheck/debug.hpp>
+#include <typecheck/debug_log.hpp>
 #include <typecheck/type.hpp>                 // for Type, TypeVar
+#include <typecheck/type_factory.hpp>
+#include <typecheck/trace.hpp>
 
 #include <typecheck/protocols/ExpressibleByFloatLiteral.hpp>
 #include <typecheck/protocols/ExpressibleByIntegerLiteral.hpp>
@@ -17,19 +20,100 @@
 
 #include <cppnotstdlib/strings.hpp>
 
+#include <algorithm>                                  // for reverse
 #include <cassert>
+#include <chrono>
+#include <deque>
 #include <optional>
+#include <functional>
 #include <list>
+#include <memory_resource>
 #include <queue>
 #include <limits>                                     // for numeric_limits
 #include <type_traits>                                // for move
 #include <utility>                                    // for make_pair
 #include <sstream>                                    // for std::stringstream
 #include <string>                                     // for std::string
+#include <string_view>
+#include <iterator>                                   // for next
+#include <unordered_map>
 
 using namespace typecheck;
 
-TypeManager::TypeManager() = default;
+TypeManager::TypeManager() : TypeManager(TypeRegistry::empty()) {}
+
+TypeManager::TypeManager(std::shared_ptr<const TypeRegistry> sharedRegistry, std::pmr::memory_resource* upstream) : shared(std::move(sharedRegistry)), workspace(upstream), pool(&this->workspace), arena(&this->pool) {
+    TYPECHECK_ASSERT(this->shared != nullptr, "Shared registry must not be null.");
+    this->updateRegistries();
+}
+
+auto TypeManager::registries() const -> const std::vector<const TypeRegistry*>& {
+    return this->registryLayers;
+}
+
+void TypeManager::updateRegistries() {
+    this->registryLayers.clear();
+    this->registryLayers.push_back(this->shared.get());
+    for (const auto* layer = this->frozen.get(); layer != nullptr; layer = layer->parent.get()) {
+        this->registryLayers.push_back(&layer->registry);
+    }
+    // Walked newest first, flip the frozen ones so they're oldest first.
+    std::reverse(this->registryLayers.begin() + 1, this->registryLayers.end());
+    this->registryLayers.push_back(&this->registry);
+}
+
+auto TypeManager::allConstraints(std::pmr::memory_resource* resource) const -> std::pmr::vector<const Constraint*> {
+    std::pmr::vector<const Constraint*> all(resource);
+    std::pmr::vector<const Frozen*> layers(resource);
+    for (const auto* layer = this->frozen.get(); layer != nullptr; layer = layer->parent.get()) {
+        layers.push_back(layer);
+    }
+
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+        for (const auto& constraint : (*it)->constraints) {
+            all.push_back(&constraint);
+        }
+    }
+    for (const auto& constraint : this->constraints) {
+        all.push_back(&constraint);
+    }
+    return all;
+}
+
+auto TypeManager::hasTypeVar(const std::string& symbol) const -> bool {
+    if (this->registeredTypeVars.find(symbol) != this->registeredTypeVars.end()) {
+        return true;
+    }
+
+    for (const auto* layer = this->frozen.get(); layer != nullptr; layer = layer->parent.get()) {
+        if (layer->typeVars.find(symbol) != layer->typeVars.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto TypeManager::fork() -> std::unique_ptr<TypeManager> {
+    const auto hasLocalState = !this->constraints.empty() || !this->registeredTypeVars.empty() ||
+        !this->registry.types().empty() || !this->registry.conversions().empty() || !this->registry.functions().empty();
+    if (hasLocalState) {
+        // Moving leaves the local state empty, ready for whatever is added next.
+        auto layer = std::make_shared<Frozen>();
+        layer->parent = std::move(this->frozen);
+        layer->registry = std::exchange(this->registry, TypeRegistry{});
+        layer->constraints = std::exchange(this->constraints, {});
+        layer->typeVars = std::exchange(this->registeredTypeVars, {});
+        this->frozen = std::move(layer);
+        this->updateRegistries();
+    }
+
+    auto child = std::make_unique<TypeManager>(this->shared, this->workspace.upstream());
+    child->frozen = this->frozen;
+    child->type_generator = this->type_generator;
+    child->constraint_generator = this->constraint_generator;
+    child->updateRegistries();
+    return child;
+}
 
 auto TypeManager::registerType(const std::string& name) -> bool {
     Type ty;
@@ -43,45 +127,90 @@ auto TypeManager::registerType(const Type& name) -> bool {
 	if (!alreadyHasType) {
 		Type type;
 		type.CopyFrom(name);
-		this->registeredTypes.emplace_back(type);
+		this->registry.registerType(type);
 	}
 	return !alreadyHasType;
 }
 
+auto TypeManager::registerTypes(const std::vector<std::string>& names) -> std::size_t {
+    TYPECHECK_TRACE_SPAN("register types");
+    if (this->frozen == nullptr && this->shared->types().empty()) {
+        return this->registry.registerTypes(names);
+    }
+
+    // Skip those already shared or frozen by `fork`.
+    std::vector<std::string> unshared;
+    for (const auto& name : names) {
+        if (this->findRegisteredType(name) == nullptr) {
+            unshared.push_back(name);
+        }
+    }
+    return this->registry.registerTypes(unshared);
+}
+
+auto TypeManager::registerTypes(const std::vector<Type>& types) -> std::size_t {
+    TYPECHECK_TRACE_SPAN("register types");
+    if (this->frozen == nullptr && this->shared->types().empty()) {
+        return this->registry.registerTypes(types);
+    }
+
+    std::vector<Type> unshared;
+    for (const auto& type : types) {
+        if (!this->hasRegisteredType(type)) {
+            unshared.push_back(type);
+        }
+    }
+    return this->registry.registerTypes(unshared);
+}
+
 auto TypeManager::hasRegisteredType(const std::string& name) const noexcept -> bool {
-    const auto returned = this->getRegisteredType(name);
-    return returned.has_raw() || returned.has_func();
+    return this->findRegisteredType(name) != nullptr;
 }
 
 auto TypeManager::hasRegisteredType(const Type& name) const noexcept -> bool {
-    const auto returned = this->getRegisteredType(name);
-    return returned.has_raw() || returned.has_func();
+    return this->findRegisteredType(name) != nullptr;
 }
 
 auto TypeManager::getRegisteredType(const std::string& name) const noexcept -> Type {
-    Type ty;
-    ty.mutable_raw()->set_name(name);
-    return this->getRegisteredType(ty);
+    const auto* registered = this->findRegisteredType(name);
+    return registered != nullptr ? *registered : Type{};
 }
 
 auto TypeManager::getRegisteredType(const Type& name) const noexcept -> Type {
-	for (auto& type : this->registeredTypes) {
-        if (type == name) {
-			return type;
+    const auto* registered = this->findRegisteredType(name);
+    return registered != nullptr ? *registered : Type{};
+}
+
+auto TypeManager::findRegisteredType(const Type& name) const noexcept -> const Type* {
+	for (const auto* layer : this->registries()) {
+        if (const auto* registered = layer->findRegisteredType(name)) {
+			return registered;
+		}
+	}
+
+	return nullptr;
+}
+
+auto TypeManager::findRegisteredType(std::string_view name) const noexcept -> const Type* {
+	for (const auto* layer : this->registries()) {
+        if (const auto* registered = layer->findRegisteredType(name)) {
+			return registered;
 		}
 	}
 
-	return {};
+	return nullptr;
 }
 
 auto TypeManager::getFunctionOverloads(const Constraint::IDType& funcID) const -> std::vector<FunctionVar> {
     std::vector<FunctionVar> overloads;
-    for (const auto& overload : this->functions) {
-        // Lookup by 'var', to deal with anonymous functions.
-        if (overload.id() == funcID) {
-            // Copy it over, and hand it over a 'function definition'.
+    for (const auto* layer : this->registries()) {
+        for (const auto& overload : layer->functions()) {
+            // Lookup by 'var', to deal with anonymous functions.
+            if (overload.id() == funcID) {
+                // Copy it over, and hand it over a 'function definition'.
 
-            overloads.push_back(overload);
+                overloads.push_back(overload);
+            }
         }
     }
 
@@ -124,51 +253,44 @@ auto TypeManager::setConvertible(const Type& T0, const Type& T1) -> bool {
     if (t0_ptr.has_func() || t1_ptr.has_func()) {
         // Functions not convertible to each other
         return false;
-    } else if (!t0_ptr.raw().name().empty() && !t1_ptr.raw().name().empty() && this->convertible[t0_ptr.raw().name()].find(t1_ptr.raw().name()) == this->convertible[t0_ptr.raw().name()].end()) {
-		// Convertible from T0 -> T1
-        this->convertible[t0_ptr.raw().name()].insert(t1_ptr.raw().name());
-		return true;
-	}
-	return false;
-}
-
-auto TypeManager::isConvertible(const std::string& T0, const std::string& T1) const noexcept -> bool {
-    Type t0;
-    t0.mutable_raw()->set_name(T0);
+    } else if (this->isConvertible(t0_ptr.raw().name(), t1_ptr.raw().name())) {
+        // Already here, shared or frozen by `fork`.
+        return false;
+    }
 
-    Type t1;
-    t1.mutable_raw()->set_name(T1);
-    return this->isConvertible(t0, t1);
+    // Convertible from T0 -> T1
+    return this->registry.addConversion(t0_ptr.raw().name(), t1_ptr.raw().name());
 }
 
-auto TypeManager::isConvertible(const Type& T0, const Type& T1) const noexcept -> bool {
-    if (T0.raw().name().empty() || T1.raw().name().empty()) {
+auto TypeManager::isConvertible(const std::string& T0, const std::string& T1) const noexcept -> bool {
+    if (T0.empty() || T1.empty()) {
         // Undefined types, stop here.
         return false;
     }
 
-    // Function types not convertible
-    if (T0.has_func() || T1.has_func()) {
-        return false;
-    }
-
     if (T0 == T1) {
 		return true;
 	}
 
-    // Because they're not functions, they must both be raw.
-    if (this->convertible.find(T0.raw().name()) == this->convertible.end()) {
-		// T0 is not in the map, meaning the conversion won't be there.
-		return false;
-	}
-
-    if (this->convertible.at(T0.raw().name()).find(T1.raw().name()) != this->convertible.at(T0.raw().name()).end()) {
-		// Convertible from T0 -> T1
-		return true;
-	}
+    for (const auto* layer : this->registries()) {
+        if (layer->hasConversion(T0, T1)) {
+            // Convertible from T0 -> T1
+            return true;
+        }
+    }
 	return false;
 }
 
+auto TypeManager::isConvertible(const Type& T0, const Type& T1) const noexcept -> bool {
+    // Function types not convertible, check first so `raw()` doesn't replace them.
+    if (T0.has_func() || T1.has_func()) {
+        return false;
+    }
+
+    // Because they're not functions, they must both be raw (or undefined).
+    return this->isConvertible(T0.raw().name(), T1.raw().name());
+}
+
 auto TypeManager::getConvertible(const Type& T0) const -> std::vector<Type> {
     std::vector<Type> out;
 
@@ -177,9 +299,14 @@ auto TypeManager::getConvertible(const Type& T0) const -> std::vector<Type> {
         return out;
     }
 
-    if (this->convertible.find(T0.raw().name()) != this->convertible.end()) {
+    for (const auto* layer : this->registries()) {
+        const auto it = layer->conversions().find(T0.raw().name());
+        if (it == layer->conversions().end()) {
+            continue;
+        }
+
         // Load into vector
-        for (auto& convert : this->convertible.at(T0.raw().name())) {
+        for (const auto& convert : it->second) {
             Type type;
             type.mutable_raw()->set_name(convert);
             out.emplace_back(std::move(type));
@@ -216,24 +343,45 @@ auto TypeManager::getConstraint(const Constraint::IDType id) const -> const Cons
 		}
 	}
 
+	for (const auto* layer = this->frozen.get(); layer != nullptr; layer = layer->parent.get()) {
+		for (const auto& constraint : layer->constraints) {
+			if (constraint.id() == id) {
+				return &constraint;
+			}
+		}
+	}
+
 	return nullptr;
 }
 
 namespace {
-    typecheck::Type TypeFromString(const std::string& val, const constraint::Solution& sol) {
-        if (cppnotstdlib::string::explode(val, '|').size() == 1) {
-            return Type(RawType(val));
+    // Values seen before (function types especially) are built once, and their types shared.
+    using BuiltTypes = std::pmr::unordered_map<std::string, TypeFactory::Ref>;
+
+    // `lookup` gives the value of a variable, needed for the arguments and return types of overloads.
+    template<typename Lookup>
+    TypeFactory::Ref TypeFromString(const std::string& val, const Lookup& lookup, TypeFactory& factory, BuiltTypes& built) {
+        const auto it = built.find(val);
+        if (it != built.end()) {
+            return it->second;
+        }
+
+        TypeFactory::Ref type;
+        if (val.find('|') == std::string::npos) {
+            type = factory.raw(val);
         } else {
-            auto fvar = typecheck::FunctionVar::unserialize(val);
-            typecheck::FunctionDefinition funcDef;
-            funcDef.set_name(fvar.name());
-            funcDef.set_id(fvar.id());
-            funcDef.mutable_returntype()->CopyFrom(TypeFromString(sol.at(fvar.returnvar().symbol()).to_string(), sol));
+            const auto fvar = typecheck::FunctionVar::unserialize(val);
+            std::vector<TypeFactory::Ref> args;
+            args.reserve(fvar.args().size());
             for (const auto& a : fvar.args()) {
-                funcDef.add_args()->CopyFrom(TypeFromString(sol.at(a.symbol()).to_string(), sol));
+                args.push_back(TypeFromString(lookup(a.symbol()), lookup, factory, built));
             }
-            return Type(funcDef);
+            const auto returnType = TypeFromString(lookup(fvar.returnvar().symbol()), lookup, factory, built);
+            type = factory.function(fvar.name(), fvar.id(), args, returnType);
         }
+
+        built.emplace(val, type);
+        return type;
     }
 
     void AddTypeToDomain(constraint::Domain::data_type& domain, const typecheck::Type& type) {
@@ -248,6 +396,39 @@ namespace {
         domain.emplace_back(type.serialize());
     }
 
+    // The search tries values in order, so a hinted type goes first.
+    auto HintedFirst(constraint::Domain::data_type domain, std::string_view hint) -> constraint::Domain::data_type {
+        constraint::Domain::data_type hinted;
+        hinted.emplace_back(std::string(hint));
+        const auto it = std::find(domain.begin(), domain.end(), hinted.front());
+        if (it != domain.end()) {
+            std::rotate(domain.begin(), it, std::next(it));
+        }
+        return domain;
+    }
+
+#ifdef TYPECHECK_ENABLE_TRACING
+    auto GatherSpanName(const ConstraintKind kind) -> const char* {
+        switch (kind) {
+        case Bind:
+            return "gather Bind";
+        case Equal:
+            return "gather Equal";
+        case BindParam:
+            return "gather BindParam";
+        case Conversion:
+            return "gather Conversion";
+        case ConformsTo:
+            return "gather ConformsTo";
+        case ApplicableFunction:
+            return "gather ApplicableFunction";
+        case BindOverload:
+            return "gather BindOverload";
+        }
+        return "gather";
+    }
+#endif
+
     using distance_type = std::function<std::size_t(const constraint::State&)>;
 
     template<typename T>
@@ -264,12 +445,18 @@ namespace {
 
     template<typename T>
     void AddHeuristicProtocolFuncs(std::vector<constraint::Solver::DistanceFunc>& heuristics, std::vector<constraint::Solver::DistanceFunc>& actuals, const std::string& var) {
-        heuristics.emplace_back([var](const constraint::StateQuery& state) {
-            T protocol;
+        // Looked up once, rather than every time the search scores a state.
+        std::vector<std::string> preferred;
+        for (const auto& ty : T().getPreferredTypes()) {
+            preferred.push_back(ty.raw().name());
+        }
+
+        auto distance = [var, preferred = std::move(preferred)](const constraint::StateQuery& state) {
             if (state.isAssigned(var)) {
                 // Check if in preferred list or not.
-                for (const auto& ty : protocol.getPreferredTypes()) {
-                    if (ty.raw().name() == state.variable_map.at(var).to_string()) {
+                const auto value = state.variable_map.at(var).to_string();
+                for (const auto& name : preferred) {
+                    if (name == value) {
                         return 0;
                     }
                 }
@@ -279,67 +466,257 @@ namespace {
 
             // Unknown.
             return 0;
-        });
+        };
 
-        // Use the same one for the actual solution, except punish more for not assigned.
-        actuals.emplace_back([var](const constraint::StateQuery& state) {
-            T protocol;
-            if (state.isAssigned(var)) {
-                // Check if in preferred list or not.
-                for (const auto& ty : protocol.getPreferredTypes()) {
-                    if (ty.raw().name() == state.variable_map.at(var).to_string()) {
-                        return 0;
-                    }
-                }
+        heuristics.emplace_back(distance);
 
-                return 1;
+        // Use the same one for the actual solution.
+        actuals.emplace_back(std::move(distance));
+    }
+}
+
+auto TypeManager::getConflict() const -> const ConsistencyReport& {
+    return this->conflict;
+}
+
+void TypeManager::reset(const bool keepRegisteredTypes) {
+    this->constraints.clear();
+    this->registeredTypeVars.clear();
+    this->type_generator.reset();
+    this->constraint_generator.reset();
+
+    if (keepRegisteredTypes) {
+        this->registry.clearFunctions();
+
+        // Types frozen by `fork` are about to go, keep our own copy.
+        for (const auto* layer : this->registries()) {
+            if (layer == this->shared.get() || layer == &this->registry) {
+                continue;
             }
 
-            // Unknown.
-            return 0;
-        });
+            this->registry.registerTypes(layer->types());
+            for (const auto& [from, tos] : layer->conversions()) {
+                for (const auto& to : tos) {
+                    this->registry.addConversion(from, to);
+                }
+            }
+        }
+    } else {
+        this->registry.clear();
+    }
+    this->frozen = nullptr;
+    this->updateRegistries();
+
+    this->typeFactory.clear();
+    this->lastSolution.reset();
+    this->conflict = {};
+    this->stats = {};
+#ifdef TYPECHECK_ENABLE_PROFILER
+    this->profile.clear();
+#endif
+}
+
+auto TypeManager::getStats() const -> const SolveStats& {
+    return this->stats;
+}
+
+void TypeManager::setDetailedStats(const bool enabled) {
+    this->detailedStats = enabled;
+}
+
+#ifdef TYPECHECK_ENABLE_PROFILER
+auto TypeManager::getProfile() const -> const ConstraintProfile& {
+    return this->profile;
+}
+#endif
+
+auto TypeManager::solve(const SolveOptions& options) -> std::optional<ConstraintPass> {
+    return this->solveObserved(options, nullptr);
+}
+
+auto TypeManager::solveObserved(const SolveOptions& options, ObserverRef* observer) -> std::optional<ConstraintPass> {
+    TYPECHECK_TRACE_SPAN("solve");
+    const auto start = std::chrono::steady_clock::now();
+    this->stats = {};
+#ifdef TYPECHECK_ENABLE_PROFILER
+    this->profile.clear();
+#endif
+    auto solution = this->solveConstraints(options, observer);
+    // Nothing allocated from the arena outlives the solve.
+    this->arena.release();
+
+    if (options.warmStart && solution.has_value()) {
+        this->lastSolution = solution;
+    }
+
+    this->stats.solved = solution.has_value();
+    this->stats.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    return solution;
+}
+
+auto TypeManager::collectHints(const SolveOptions& options, std::pmr::memory_resource* resource) const -> Hints {
+    Hints hints(resource);
+    for (const auto& [symbol, type] : options.hints) {
+        if (type.has_raw()) {
+            hints.emplace(symbol, type.raw().name());
+        }
     }
+
+    if (options.warmStart && this->lastSolution.has_value()) {
+        // Only fills in what wasn't hinted explicitly.
+        for (const auto& [symbol, type] : this->lastSolution->getResolvedTypes()) {
+            if (type.has_raw()) {
+                hints.emplace(symbol, type.raw().name());
+            }
+        }
+    }
+    return hints;
 }
 
-auto TypeManager::solve() -> std::optional<ConstraintPass> {
+auto TypeManager::solveConstraints(const SolveOptions& options, ObserverRef* observer) -> std::optional<ConstraintPass> {
+    const auto all = this->allConstraints(&this->arena);
+    this->stats.constraints = all.size();
+
+    const auto system = [&] {
+        TYPECHECK_TRACE_SPAN("simplify");
+        return this->simplifyConstraints(all, &this->arena);
+    }();
+    const auto& active = system.kept;
+    const auto& dropped = system.dropped;
+    this->stats.simplified = dropped.size();
+
+    {
+        TYPECHECK_TRACE_SPAN("check consistency");
+        this->conflict = this->checkConsistency(active, &this->arena);
+    }
+    if (!this->conflict.consistent()) {
+        // Contradiction found without searching, `getConflict` has the constraints responsible.
+        return std::nullopt;
+    }
+
+    const auto overloads = [&] {
+        TYPECHECK_TRACE_SPAN("overload candidates");
+        return this->findOverloadCandidates(active, &this->arena, &this->stats.prunedOverloads);
+    }();
+    const auto hints = this->collectHints(options, &this->arena);
+
+    ConstraintPass lattice;
+    const auto fastPath = [&] {
+        TYPECHECK_TRACE_SPAN("lattice");
+        return options.fastPaths ? this->solveLattice(active, dropped, overloads, hints, &lattice, &this->arena) : FastPath::Fallback;
+    }();
+    switch (fastPath) {
+    case FastPath::Solved:
+        return lattice;
+    case FastPath::Unsatisfiable:
+        this->conflict.set_reason("No registered types satisfy the conversions");
+        return std::nullopt;
+    case FastPath::Fallback:
+        break;
+    }
+
+    Assignments defaulted(&this->arena);
+    const auto satisfiable = [&] {
+        TYPECHECK_TRACE_SPAN("check satisfiable");
+        return this->checkSatisfiable(system, overloads, hints, &this->conflict, &this->arena, options.nodeLimit, observer, options.fastPaths ? &defaulted : nullptr);
+    }();
+    if (satisfiable == BackjumpSolver::Unsatisfiable) {
+        // Conflict analysis proved there is no solution, skip the optimizing search.
+        return std::nullopt;
+    }
+
+    if (!defaulted.empty()) {
+        TYPECHECK_TRACE_SPAN("reconstruct types");
+        ConstraintPass pass;
+        BuiltTypes built(&this->arena);
+        const auto lookup = [&defaulted](const std::string& var) -> const std::string& {
+            return defaulted.at(var);
+        };
+        for (const auto& [var, val] : defaulted) {
+            pass.setResolvedType(var, TypeFromString(val, lookup, this->typeFactory, built).type());
+        }
+        this->stats.path = SolveStats::Defaulted;
+        this->stats.variables = defaulted.size();
+        return pass;
+    }
+
     constraint::Solver constraint_solver;
-    std::set<std::string> all_variable_names;
+    std::pmr::set<std::string> all_variable_names(&this->arena);
+
+    // Variables of each constraint, kept alive here so the constraints can refer to them instead of copying.
+    std::pmr::deque<std::vector<std::string>> scopes(&this->arena);
+    std::pmr::deque<std::vector<FunctionVar>> families(&this->arena);
+    std::pmr::deque<std::pmr::unordered_map<std::string, std::size_t>> rowTables(&this->arena);
+
+    // Counts evaluations of each constraint, when asked to.
+    auto add_constraint = [this, &constraint_solver](const Constraint::IDType id, const std::vector<std::string>& scope, std::function<bool(const constraint::Env&)> predicate) {
+        if (this->detailedStats) {
+            auto* count = &this->stats.evaluations[id];
+            predicate = [count, inner = std::move(predicate)](const constraint::Env& env) {
+                ++*count;
+                return inner(env);
+            };
+        }
+#ifdef TYPECHECK_ENABLE_PROFILER
+        predicate = [entry = this->profile.entry(id), inner = std::move(predicate)](const constraint::Env& env) {
+            const auto begin = std::chrono::steady_clock::now();
+            const auto satisfied = inner(env);
+            entry->time += std::chrono::steady_clock::now() - begin;
+            ++entry->evaluations;
+            if (!satisfied) {
+                ++entry->failures;
+            }
+            return satisfied;
+        };
+#endif
+        constraint_solver.addConstraint(scope, std::move(predicate));
+    };
 
     std::vector<constraint::Solver::DistanceFunc> heuristcFuncs;
     std::vector<constraint::Solver::DistanceFunc> distanceFuncs;
 
 #pragma mark - Gather All Data
-    auto insert_if_not_exists = [&constraint_solver, &all_variable_names](const std::string& var, const constraint::Domain& domain) {
+    auto insert_if_not_exists = [&constraint_solver, &all_variable_names, &hints](const std::string& var, const constraint::Domain::data_type& domain) {
         if (domain.size() == 0) {
-            std::cout << "Warning: Domain Empty for variable: " << var << std::endl;
+            DebugLog::record(DebugLog::Event::EmptyDomain, var);
         }
 
         if (all_variable_names.find(var) == all_variable_names.end()) {
-            constraint_solver.addVariable(var, domain);
+            const auto hint = hints.find(var);
+            constraint_solver.addVariable(var, constraint::Domain(hint == hints.end() ? domain : HintedFirst(domain, hint->second)));
             all_variable_names.insert(var);
         }
     };
 
     // Var Domain
     const auto varDomain = [this] {
+        TYPECHECK_TRACE_SPAN("build domains");
         constraint::Domain::data_type domain;
-        for (const auto& ty : this->registeredTypes) {
-            AddTypeToDomain(domain, ty);
+        for (const auto* layer : this->registries()) {
+            for (const auto& ty : layer->types()) {
+                AddTypeToDomain(domain, ty);
+            }
         }
 
-        for (const auto& func : this->functions) {
-            AddTypeToDomain(domain, func);
+        for (const auto* layer : this->registries()) {
+            for (const auto& func : layer->functions()) {
+                AddTypeToDomain(domain, func);
+            }
         }
 
-        return constraint::Domain(domain);
+        return domain;
     }();
 
-    for (const auto& constraint : this->constraints) {
+    TYPECHECK_TRACE_BEGIN(gatherSpan, "gather constraints");
+    TYPECHECK_TRACE_TOTALS(gatherTotals, BindOverload + 1);
+    for (const auto* constraintPtr : active) {
+        const auto& constraint = *constraintPtr;
+        TYPECHECK_TRACE_STEP(gatherTotals, constraint.kind(), GatherSpanName(constraint.kind()));
         if (constraint.has_conforms()) {
-            const auto conforms = constraint.conforms();
+            const auto& conforms = constraint.conforms();
             if (conforms.has_type() && conforms.has_protocol()) {
                 const auto var = conforms.type().symbol();
-                const auto protocol = conforms.protocol();
+                const auto& protocol = conforms.protocol();
                 constraint::Domain::data_type domain;
                 switch (protocol.literal()) {
                 case KnownProtocolKind::ExpressibleByFloat:
@@ -360,14 +737,14 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
 				case KnownProtocolKind::ExpressibleByNil:
 				case KnownProtocolKind::ExpressibleByString:
                 default:
-                    std::cout << "Unsupported Literal" << std::endl;
+                    DebugLog::record(DebugLog::Event::UnsupportedLiteral, constraint);
                     return std::nullopt;
                     break;
                 }
                 insert_if_not_exists(var, varDomain);
 
                 // conforms literal is implied by its domain.
-                constraint_solver.addConstraint(std::vector{var}, [var, domain](const constraint::Env& env) {
+                add_constraint(constraint.id(), std::vector{var}, [var, domain = std::move(domain)](const constraint::Env& env) {
                     for (const auto& ty : domain) {
                         if (env.at(var) == ty) {
                             return true;
@@ -377,12 +754,12 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
                     return false;
                 });
             } else {
-                std::cout << "Malformed Conforms Constraint" << std::endl;
+                DebugLog::record(DebugLog::Event::MalformedConstraint, constraint);
                 return std::nullopt;
             }
         } else if (constraint.has_types()) {
-            const auto types = constraint.types();
-            std::vector<std::string> type_names;
+            const auto& types = constraint.types();
+            auto& type_names = scopes.emplace_back();
             if (types.has_first()) {
                 type_names.push_back(types.first().symbol());
             }
@@ -394,7 +771,7 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
             }
 
             if (type_names.empty()) {
-                std::cout << "Malformed Types Constraint" << std::endl;
+                DebugLog::record(DebugLog::Event::MalformedConstraint, constraint);
             } else {
                 for (const auto& ty : type_names) {
                     insert_if_not_exists(ty, varDomain);
@@ -402,7 +779,7 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
 
                 switch (constraint.kind()) {
                 case Conversion:
-                    constraint_solver.addConstraint(std::vector{type_names}, [type_names, C = &convertible](const constraint::Env& env) {
+                    add_constraint(constraint.id(), type_names, [&type_names, &registries = this->registries()](const constraint::Env& env) {
                         const auto firstVarValue = env.at(type_names.at(0));
                         const auto secondVarValue = env.at(type_names.at(1));
 
@@ -410,16 +787,16 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
                             return true;
                         }
 
-                        const auto it = C->find(firstVarValue.to_string());
-                        if (it == C->end()) {
-                            return false;
+                        for (const auto* layer : registries) {
+                            if (layer->hasConversion(firstVarValue.to_string(), secondVarValue.to_string())) {
+                                return true;
+                            }
                         }
-
-                        return it->second.find(secondVarValue.to_string()) != it->second.end();
+                        return false;
                     });
                     break;
                 case Equal:
-                    constraint_solver.addConstraint(std::vector{type_names}, [type_names](const constraint::Env& env) {
+                    add_constraint(constraint.id(), type_names, [&type_names](const constraint::Env& env) {
                         const auto firstVar = env.at(type_names.at(0));
                         for (const auto& ty : type_names) {
                             if (firstVar != env.at(ty)) {
@@ -436,110 +813,101 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
 				case ConformsTo:
 				case ApplicableFunction:
                 default:
-                    std::cout << "Unimplemented Constraint Kind: " << constraint.kind() << std::endl;
+                    DebugLog::record(DebugLog::Event::UnknownConstraint, constraint);
                     assert(false);
                     break;
                 }
             }
         } else if (constraint.has_overload()) {
-            const auto overload = constraint.overload();
+            const auto& overload = constraint.overload();
 
-            std::vector<std::string> overloadVariables;
-            overloadVariables.emplace_back(overload.type().symbol());
-            overloadVariables.emplace_back(overload.returnvar().symbol());
-            for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
-                overloadVariables.emplace_back(overload.argvars(i).symbol());
+            // Gather the overloads that could match, and which one each value of the call's type picks.
+            const auto& funcFamily = families.emplace_back(overloads.at(constraint.id()));
+            auto& rows = rowTables.emplace_back();
+            constraint::Domain::data_type typeDomain;
+            for (std::size_t i = 0; i < funcFamily.size(); ++i) {
+                auto serialized = funcFamily.at(i).serialize();
+                typeDomain.emplace_back(serialized);
+                rows.emplace(std::move(serialized), i);
             }
+            insert_if_not_exists(overload.type().symbol(), typeDomain);
 
-            // Gather all overloads.
-            const auto funcFamily = this->getFunctionOverloads(overload.functionid());
-            std::vector<std::vector<std::string>> all_func_dependant_variables;
-            constraint::Domain::data_type typeDomain;
-            for (const auto& func : funcFamily) {
-                std::vector<std::string> funcDependantVariables;
-                funcDependantVariables.emplace_back(func.returnvar().symbol());
-                for (const auto& arg : func.args()) {
-                    funcDependantVariables.emplace_back(arg.symbol());
+            // A single constraint over the call and every definition, rather than one per overload.
+            auto& overloadConstraintVars = scopes.emplace_back();
+            auto add_var = [&](const std::string& var, const constraint::Domain::data_type& domain) {
+                insert_if_not_exists(var, domain);
+                if (std::find(overloadConstraintVars.begin(), overloadConstraintVars.end(), var) == overloadConstraintVars.end()) {
+                    overloadConstraintVars.push_back(var);
                 }
+            };
 
-                all_func_dependant_variables.emplace_back(funcDependantVariables);
-                typeDomain.emplace_back(func.serialize());
-            }
-
-            insert_if_not_exists(overload.type().symbol(), typeDomain);
-            for (const auto& a : overloadVariables) {
-                insert_if_not_exists(a, varDomain);
+            add_var(overload.type().symbol(), typeDomain);
+            add_var(overload.returnvar().symbol(), varDomain);
+            for (std::size_t i = 0; i < overload.argvars_size(); ++i) {
+                add_var(overload.argvars(i).symbol(), varDomain);
             }
-            for (const auto& a : all_func_dependant_variables) {
-                for (const auto& b : a) {
-                    insert_if_not_exists(b, varDomain);
+            auto add_definition_var = [&](const TypeVar& var) {
+                if (this->shared->hasBoundType(var.symbol())) {
+                    // Shared overloads have concrete types, so there is only one choice.
+                    constraint::Domain::data_type bound;
+                    AddTypeToDomain(bound, this->shared->getBoundType(var.symbol()));
+                    add_var(var.symbol(), bound);
+                } else {
+                    add_var(var.symbol(), varDomain);
+                }
+            };
+            for (const auto& func : funcFamily) {
+                add_definition_var(func.returnvar());
+                for (const auto& arg : func.args()) {
+                    add_definition_var(arg);
                 }
             }
 
+            add_constraint(constraint.id(), overloadConstraintVars, [&overload, &funcFamily, &rows](const constraint::Env& env) {
+                const auto row = rows.find(env.at(overload.type().symbol()).to_string());
+                if (row == rows.end()) {
+                    return false;
+                }
 
-            for (std::size_t i = 0; i < funcFamily.size(); ++i) {
-                const auto& vars = all_func_dependant_variables.at(i);
-                const auto& func = funcFamily.at(i);
-
-                std::vector<std::string> overloadConstraintVars;
-
-                // Copy the variables from the overload constraint
-                std::copy(overloadVariables.begin(), overloadVariables.end(), std::back_inserter(overloadConstraintVars));
-
-                // Copy the variables from the function definition
-                std::copy(vars.begin(), vars.end(), std::back_inserter(overloadConstraintVars));
-
-                auto allFuncDefinitionVariablesAssigned = [vars](const constraint::Env& env) {
-                    for (const auto& a : vars) {
-                        if (!env.isAssigned(a)) {
-                            return false;
-                        }
-                    }
+                const auto& funcDefinition = funcFamily.at(row->second);
+                const auto assigned = env.isAssigned(funcDefinition.returnvar().symbol()) && std::all_of(funcDefinition.args().begin(), funcDefinition.args().end(), [&env](const TypeVar& arg) {
+                    return env.isAssigned(arg.symbol());
+                });
+                if (!assigned) {
+                    // If not all the variables of the function are assigned, say it's fine, and a later state will pick it up.
                     return true;
-                };
-
-                constraint_solver.addConstraint(overloadConstraintVars, [overload, funcDefinition = func, check = std::move(allFuncDefinitionVariablesAssigned)](const constraint::Env& env) {
-                    if (!check(env)) {
-                        // If not all the variables of the function are assigned, say it's fine, and the other one will pick it up.
-                        return true;
-                    }
+                }
 
-                    if (env.at(overload.type().symbol()).to_string() != funcDefinition.serialize()) {
-                        // This is not the overload we are looking for.
-                        return true;
-                    }
+                auto compare_vars = [&env](const typecheck::TypeVar& vA, const typecheck::TypeVar& vB) {
+                    return env.at(vA.symbol()) == env.at(vB.symbol());
+                };
 
-                    auto compare_vars = [&env](const typecheck::TypeVar& vA, const typecheck::TypeVar& vB) {
-                        return env.at(vA.symbol()).to_string() == env.at(vB.symbol()).to_string();
-                    };
+                // This is the the overload, check everything matches up.
+                if (overload.argvars_size() != funcDefinition.args().size()) {
+                    return false;
+                }
 
-                    // This is the the overload, check everything matches up.
-                    if (overload.argvars_size() != funcDefinition.args().size()) {
-                        return false;
-                    }
+                if (!compare_vars(overload.returnvar(), funcDefinition.returnvar())) {
+                    return false;
+                }
 
-                    if (!compare_vars(overload.returnvar(), funcDefinition.returnvar())) {
+                for (std::size_t i = 0; i < funcDefinition.args().size(); ++i) {
+                    if (!compare_vars(overload.argvars(i), funcDefinition.args().at(i))) {
                         return false;
                     }
+                }
 
-                    for (std::size_t i = 0; i < funcDefinition.args().size(); ++i) {
-                        if (!compare_vars(overload.argvars(i), funcDefinition.args().at(i))) {
-                            return false;
-                        }
-                    }
-
-                    return true;
-                });
-            }
+                return true;
+            });
 
         } else if (constraint.has_explicit_()) {
-            const auto explicit_ = constraint.explicit_();
+            const auto& explicit_ = constraint.explicit_();
             if (explicit_.has_var() && explicit_.has_type()) {
-                const auto var = explicit_.var();
-                const auto type = explicit_.type();
+                const auto& var = explicit_.var();
+                const auto& type = explicit_.type();
 
                 insert_if_not_exists(var.symbol(), varDomain);
-                constraint_solver.addConstraint(std::vector{var.symbol()}, [var, type](const constraint::Env& env) {
+                add_constraint(constraint.id(), std::vector{var.symbol()}, [&var, &type](const constraint::Env& env) {
                     if (type.has_raw()) {
                         return env.at(var.symbol()).to_string() == type.raw().name();
                     } else {
@@ -547,17 +915,37 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
                     }
                 });
             } else {
-                std::cout << "Malformed Explicit Constraint" << std::endl;
+                DebugLog::record(DebugLog::Event::MalformedConstraint, constraint);
                 return std::nullopt;
             }
         } else {
-            std::cout << "Unknown Constraint Type" << std::endl;
+            DebugLog::record(DebugLog::Event::UnknownConstraint, constraint);
             return std::nullopt;
         }
     }
 
+    // Simplified constraints add nothing to solve, but their variables still need a type.
+    for (const auto* constraint : dropped) {
+        if (constraint->has_types()) {
+            const auto& types = constraint->types();
+            if (types.has_first()) {
+                insert_if_not_exists(types.first().symbol(), varDomain);
+            }
+            if (types.has_second()) {
+                insert_if_not_exists(types.second().symbol(), varDomain);
+            }
+            if (types.has_third()) {
+                insert_if_not_exists(types.third().symbol(), varDomain);
+            }
+        }
+    }
 
+    TYPECHECK_TRACE_END(gatherTotals);
+    TYPECHECK_TRACE_END(gatherSpan);
+
+    TYPECHECK_TRACE_BEGIN(heuristicSpan, "heuristic setup");
     const auto numVariables = all_variable_names.size();
+    this->stats.variables = numVariables;
     auto heuristic = [heuristics = std::move(heuristcFuncs), numVariables](const constraint::StateQuery& state) {
         // Calculate the difference, allows us to measure meaningful progress
         std::size_t sum = numVariables + state.numConstraints() - state.numSatisfied();
@@ -576,16 +964,24 @@ auto TypeManager::solve() -> std::optional<ConstraintPass> {
         return sum;
     };
 
+    TYPECHECK_TRACE_END(heuristicSpan);
+
+    TYPECHECK_TRACE_BEGIN(searchSpan, "search");
     const auto solution = constraint_solver.getOptimizedSolution(std::move(heuristic), std::move(actualDistance));
+    TYPECHECK_TRACE_END(searchSpan);
     const auto hasSolution = solution.has_value();
     if (!hasSolution) {
         return std::nullopt;
     }
 
+    TYPECHECK_TRACE_SPAN("reconstruct types");
     ConstraintPass pass;
+    BuiltTypes built(&this->arena);
+    const auto lookup = [&solution](const std::string& var) {
+        return solution->at(var).to_string();
+    };
     for (const auto& var : all_variable_names) {
-        const auto val = solution->at(var);
-        pass.setResolvedType(var, TypeFromString(val.to_string(), *solution));
+        pass.setResolvedType(var, TypeFromString(solution->at(var).to_string(), lookup, this->typeFactory, built).type());
     }
     return pass;
 }
@@ -0,0 +1,334 @@
+#include <typecheck/type_registry.hpp>
+#include <typecheck/function_var.hpp>
+#include <typecheck/type.hpp>
+
+#include <cstdint>
+#include <cstring>    // for memcpy
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TYPECHECK_SNAPSHOT_MMAP
+#endif
+
+using namespace typecheck;
+
+namespace {
+	// Layout (native byte order):
+	//     magic, version, byte order marker
+	//     registered types, conversions, function overloads, bound types, next generated symbol
+	// Counts are u64, strings are a u64 length followed by the bytes.
+	constexpr std::string_view SNAPSHOT_MAGIC = "TCRG";
+	constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+	constexpr std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+	// Deeper function types than this are treated as malformed, rather than overflowing the stack.
+	constexpr std::size_t SNAPSHOT_MAX_DEPTH = 256;
+
+	enum TypeTag : std::uint8_t {
+		EmptyTag = 0,
+		RawTag,
+		FunctionTag
+	};
+
+	class SnapshotWriter {
+	public:
+		template<typename T>
+		void write(const T value) {
+			char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+			this->out.append(bytes, sizeof(T));
+		}
+
+		void write(std::string_view str) {
+			this->write<std::uint64_t>(str.size());
+			this->out.append(str.data(), str.size());
+		}
+
+		void write(const Type& type) {
+			if (type.has_raw()) {
+				this->write<std::uint8_t>(RawTag);
+				this->write(std::string_view(type.raw().name()));
+			} else if (type.has_func()) {
+				const auto& func = type.func();
+				this->write<std::uint8_t>(FunctionTag);
+				this->write(std::string_view(func.name()));
+				this->write<std::int64_t>(func.id());
+				this->write<std::uint8_t>(func.has_returntype());
+				if (func.has_returntype()) {
+					this->write(func.returntype());
+				}
+				this->write<std::uint64_t>(func.args_size());
+				for (std::size_t i = 0; i < func.args_size(); ++i) {
+					this->write(func.args(i));
+				}
+			} else {
+				this->write<std::uint8_t>(EmptyTag);
+			}
+		}
+
+		std::string out;
+	};
+
+	class SnapshotReader {
+	public:
+		explicit SnapshotReader(std::string_view snapshot) : data(snapshot) {}
+
+		template<typename T>
+		bool read(T* value) {
+			if (this->data.size() - this->pos < sizeof(T)) {
+				return false;
+			}
+			std::memcpy(value, this->data.data() + this->pos, sizeof(T));
+			this->pos += sizeof(T);
+			return true;
+		}
+
+		bool read(std::string_view* str) {
+			std::uint64_t size = 0;
+			if (!this->read(&size) || this->data.size() - this->pos < size) {
+				return false;
+			}
+			*str = this->data.substr(this->pos, size);
+			this->pos += size;
+			return true;
+		}
+
+		bool read(std::string* str) {
+			std::string_view view;
+			if (!this->read(&view)) {
+				return false;
+			}
+			str->assign(view);
+			return true;
+		}
+
+		bool read(Type* type, const std::size_t depth = 0) {
+			std::uint8_t tag = EmptyTag;
+			if (depth > SNAPSHOT_MAX_DEPTH || !this->read(&tag)) {
+				return false;
+			}
+
+			switch (tag) {
+			case EmptyTag:
+				return true;
+			case RawTag: {
+				std::string name;
+				if (!this->read(&name)) {
+					return false;
+				}
+				type->mutable_raw()->set_name(name);
+				return true;
+			}
+			case FunctionTag: {
+				std::string name;
+				std::int64_t id = 0;
+				std::uint8_t hasReturnType = 0;
+				if (!this->read(&name) || !this->read(&id) || !this->read(&hasReturnType)) {
+					return false;
+				}
+
+				auto* func = type->mutable_func();
+				func->set_name(name);
+				func->set_id(id);
+				if (hasReturnType != 0 && !this->read(func->mutable_returntype(), depth + 1)) {
+					return false;
+				}
+
+				std::uint64_t numArgs = 0;
+				if (!this->read(&numArgs)) {
+					return false;
+				}
+				for (std::uint64_t i = 0; i < numArgs; ++i) {
+					if (!this->read(func->add_args(), depth + 1)) {
+						return false;
+					}
+				}
+				return true;
+			}
+			default:
+				return false;
+			}
+		}
+
+		bool done() const {
+			return this->pos == this->data.size();
+		}
+
+	private:
+		std::string_view data;
+		std::size_t pos = 0;
+	};
+}
+
+auto TypeRegistry::serialize() const -> std::string {
+	SnapshotWriter writer;
+	writer.out.append(SNAPSHOT_MAGIC.data(), SNAPSHOT_MAGIC.size());
+	writer.write(SNAPSHOT_VERSION);
+	writer.write(SNAPSHOT_BYTE_ORDER);
+
+	writer.write<std::uint64_t>(this->registeredTypes.size());
+	for (const auto& type : this->registeredTypes) {
+		writer.write(type);
+	}
+
+	writer.write<std::uint64_t>(this->convertible.size());
+	for (const auto& [from, tos] : this->convertible) {
+		writer.write(std::string_view(from));
+		writer.write<std::uint64_t>(tos.size());
+		for (const auto& to : tos) {
+			writer.write(std::string_view(to));
+		}
+	}
+
+	writer.write<std::uint64_t>(this->_functions.size());
+	for (const auto& func : this->_functions) {
+		writer.write(std::string_view(func.serialize()));
+	}
+
+	writer.write<std::uint64_t>(this->boundTypes.size());
+	for (const auto& [symbol, type] : this->boundTypes) {
+		writer.write(std::string_view(symbol));
+		writer.write(type);
+	}
+
+	writer.write<std::int64_t>(this->type_generator.count());
+	return std::move(writer.out);
+}
+
+auto TypeRegistry::unserialize(std::string_view snapshot) -> std::optional<TypeRegistry> {
+	if (snapshot.substr(0, SNAPSHOT_MAGIC.size()) != SNAPSHOT_MAGIC) {
+		return std::nullopt;
+	}
+
+	SnapshotReader reader(snapshot.substr(SNAPSHOT_MAGIC.size()));
+	std::uint32_t version = 0;
+	std::uint32_t byteOrder = 0;
+	if (!reader.read(&version) || !reader.read(&byteOrder) || version != SNAPSHOT_VERSION || byteOrder != SNAPSHOT_BYTE_ORDER) {
+		return std::nullopt;
+	}
+
+	// The snapshot was written from a valid registry, so skip the duplicate checks made when registering.
+	TypeRegistry registry;
+	std::uint64_t numTypes = 0;
+	if (!reader.read(&numTypes)) {
+		return std::nullopt;
+	}
+	for (std::uint64_t i = 0; i < numTypes; ++i) {
+		Type type;
+		if (!reader.read(&type)) {
+			return std::nullopt;
+		}
+		registry.typeIndex.emplace(type.hash(), registry.registeredTypes.size());
+		registry.registeredTypes.emplace_back(std::move(type));
+	}
+
+	std::uint64_t numConversions = 0;
+	if (!reader.read(&numConversions)) {
+		return std::nullopt;
+	}
+	for (std::uint64_t i = 0; i < numConversions; ++i) {
+		std::string from;
+		std::uint64_t numTos = 0;
+		if (!reader.read(&from) || !reader.read(&numTos)) {
+			return std::nullopt;
+		}
+
+		// Written in order, so each insert goes at the end.
+		auto& tos = registry.convertible.emplace_hint(registry.convertible.end(), std::move(from), std::set<std::string>{})->second;
+		for (std::uint64_t j = 0; j < numTos; ++j) {
+			std::string to;
+			if (!reader.read(&to)) {
+				return std::nullopt;
+			}
+			tos.emplace_hint(tos.end(), std::move(to));
+		}
+	}
+
+	std::uint64_t numFunctions = 0;
+	if (!reader.read(&numFunctions)) {
+		return std::nullopt;
+	}
+	for (std::uint64_t i = 0; i < numFunctions; ++i) {
+		std::string func;
+		if (!reader.read(&func)) {
+			return std::nullopt;
+		}
+
+		try {
+			registry._functions.push_back(FunctionVar::unserialize(func));
+		} catch (const std::exception&) {
+			return std::nullopt;
+		}
+	}
+
+	std::uint64_t numBound = 0;
+	if (!reader.read(&numBound)) {
+		return std::nullopt;
+	}
+	for (std::uint64_t i = 0; i < numBound; ++i) {
+		std::string symbol;
+		Type type;
+		if (!reader.read(&symbol) || !reader.read(&type)) {
+			return std::nullopt;
+		}
+		registry.boundTypes.emplace_hint(registry.boundTypes.end(), std::move(symbol), std::move(type));
+	}
+
+	std::int64_t nextSymbol = 0;
+	if (!reader.read(&nextSymbol) || !reader.done()) {
+		return std::nullopt;
+	}
+	registry.type_generator.reset(nextSymbol);
+
+	return registry;
+}
+
+auto TypeRegistry::save(const std::string& path) const -> bool {
+	const auto snapshot = this->serialize();
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(snapshot.data(), static_cast<std::streamsize>(snapshot.size()));
+	return file.good();
+}
+
+auto TypeRegistry::load(const std::string& path) -> std::optional<TypeRegistry> {
+#ifdef TYPECHECK_SNAPSHOT_MMAP
+	const auto fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return std::nullopt;
+	}
+
+	struct stat info {};
+	if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+		::close(fd);
+		return std::nullopt;
+	}
+
+	const auto size = static_cast<std::size_t>(info.st_size);
+	void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		return std::nullopt;
+	}
+
+	auto registry = TypeRegistry::unserialize(std::string_view(static_cast<const char*>(mapped), size));
+	::munmap(mapped, size);
+	return registry;
+#else
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return std::nullopt;
+	}
+
+	const std::string snapshot((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return TypeRegistry::unserialize(snapshot);
+#endif
+}
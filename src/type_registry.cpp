@@ -0,0 +1,201 @@
+#include <typecheck/type_registry.hpp>
+#include <typecheck/debug.hpp>
+#include <typecheck/memory_usage.hpp>
+
+#include <memory>
+#include <algorithm>   // for max
+#include <functional>  // for hash
+#include <string>
+#include <string_view>
+#include <utility>  // for move
+
+using namespace typecheck;
+
+TypeRegistry::TypeRegistry() : type_generator("R") {}
+
+auto TypeRegistry::empty() -> const std::shared_ptr<const TypeRegistry>& {
+	static const auto registry = std::make_shared<const TypeRegistry>();
+	return registry;
+}
+
+auto TypeRegistry::registerType(const std::string& name) -> bool {
+	Type ty;
+	ty.mutable_raw()->set_name(name);
+	return this->registerType(ty);
+}
+
+auto TypeRegistry::registerType(const Type& type) -> bool {
+	const auto alreadyHasType = this->hasRegisteredType(type);
+	if (!alreadyHasType) {
+		this->typeIndex.emplace(type.hash(), this->registeredTypes.size());
+		this->registeredTypes.emplace_back(type);
+	}
+	return !alreadyHasType;
+}
+
+void TypeRegistry::reserveTypes(const std::size_t count) {
+	// Grow geometrically, so registering in many small batches stays linear.
+	const auto needed = this->registeredTypes.size() + count;
+	if (needed > this->registeredTypes.capacity()) {
+		this->registeredTypes.reserve(std::max(needed, 2 * this->registeredTypes.capacity()));
+		this->typeIndex.reserve(this->registeredTypes.capacity());
+	}
+}
+
+auto TypeRegistry::registerTypes(const std::vector<std::string>& names) -> std::size_t {
+	this->reserveTypes(names.size());
+
+	std::size_t added = 0;
+	for (const auto& name : names) {
+		if (this->findRegisteredType(name) == nullptr) {
+			added += this->registerType(name);
+		}
+	}
+	return added;
+}
+
+auto TypeRegistry::registerTypes(const std::vector<Type>& types) -> std::size_t {
+	this->reserveTypes(types.size());
+
+	std::size_t added = 0;
+	for (const auto& type : types) {
+		added += this->registerType(type);
+	}
+	return added;
+}
+
+auto TypeRegistry::hasRegisteredType(const Type& type) const noexcept -> bool {
+	return this->findRegisteredType(type) != nullptr;
+}
+
+auto TypeRegistry::getRegisteredType(const Type& type) const noexcept -> Type {
+	const auto* registered = this->findRegisteredType(type);
+	return registered != nullptr ? *registered : Type{};
+}
+
+auto TypeRegistry::findRegisteredType(const Type& type) const noexcept -> const Type* {
+	const auto [begin, end] = this->typeIndex.equal_range(type.hash());
+	for (auto it = begin; it != end; ++it) {
+		const auto& registered = this->registeredTypes[it->second];
+		if (registered == type) {
+			return &registered;
+		}
+	}
+
+	return nullptr;
+}
+
+auto TypeRegistry::findRegisteredType(std::string_view name) const noexcept -> const Type* {
+	const auto [begin, end] = this->typeIndex.equal_range(std::hash<std::string_view>()(name));
+	for (auto it = begin; it != end; ++it) {
+		const auto& registered = this->registeredTypes[it->second];
+		if (registered.has_raw() && registered.raw() == name) {
+			return &registered;
+		}
+	}
+
+	return nullptr;
+}
+
+auto TypeRegistry::setConvertible(const std::string& T0, const std::string& T1) -> bool {
+	Type t0;
+	t0.mutable_raw()->set_name(T0);
+
+	Type t1;
+	t1.mutable_raw()->set_name(T1);
+
+	return this->setConvertible(t0, t1);
+}
+
+auto TypeRegistry::setConvertible(const Type& T0, const Type& T1) -> bool {
+	if (T0 == T1) {
+		return true;
+	}
+
+	const auto t0 = this->getRegisteredType(T0);
+	const auto t1 = this->getRegisteredType(T1);
+
+	// Functions not convertible to each other
+	if (t0.has_func() || t1.has_func()) {
+		return false;
+	}
+
+	return this->addConversion(t0.raw().name(), t1.raw().name());
+}
+
+auto TypeRegistry::hasConversion(const std::string& T0, const std::string& T1) const noexcept -> bool {
+	const auto it = this->convertible.find(T0);
+	return it != this->convertible.end() && it->second.find(T1) != it->second.end();
+}
+
+auto TypeRegistry::addConversion(const std::string& T0, const std::string& T1) -> bool {
+	if (T0.empty() || T1.empty()) {
+		return false;
+	}
+	return this->convertible[T0].insert(T1).second;
+}
+
+auto TypeRegistry::addFunction(const Constraint::IDType& functionid, const std::vector<Type>& args, const Type& returnType) -> Constraint::IDType {
+	TYPECHECK_ASSERT(returnType.has_raw() || returnType.has_func(), "Must insert valid type.");
+
+	FunctionVar func;
+	func.set_id(functionid);
+	for (const auto& arg : args) {
+		TYPECHECK_ASSERT(arg.has_raw() || arg.has_func(), "Must insert valid type.");
+		const auto symbol = this->type_generator.next();
+		func.add_args()->set_symbol(symbol);
+		this->boundTypes.emplace(symbol, arg);
+	}
+
+	const auto symbol = this->type_generator.next();
+	func.mutable_returnvar()->set_symbol(symbol);
+	this->boundTypes.emplace(symbol, returnType);
+
+	this->addFunction(func);
+	return functionid;
+}
+
+void TypeRegistry::addFunction(const FunctionVar& func) {
+	this->_functions.push_back(func);
+}
+
+void TypeRegistry::clearFunctions() {
+	this->_functions.clear();
+	this->boundTypes.clear();
+	this->type_generator.reset();
+}
+
+void TypeRegistry::clear() {
+	this->clearFunctions();
+	this->registeredTypes.clear();
+	this->typeIndex.clear();
+	this->convertible.clear();
+}
+
+auto TypeRegistry::types() const -> const std::vector<Type>& {
+	return this->registeredTypes;
+}
+
+auto TypeRegistry::conversions() const -> const std::map<std::string, std::set<std::string>>& {
+	return this->convertible;
+}
+
+auto TypeRegistry::functions() const -> const std::vector<FunctionVar>& {
+	return this->_functions;
+}
+
+auto TypeRegistry::hasBoundType(const std::string& symbol) const -> bool {
+	return this->boundTypes.find(symbol) != this->boundTypes.end();
+}
+
+auto TypeRegistry::getBoundType(const std::string& symbol) const -> const Type& {
+	return this->boundTypes.at(symbol);
+}
+
+auto TypeRegistry::typesMemoryUsage() const -> std::size_t {
+	return heap::bytes(this->registeredTypes) + heap::bytes(this->typeIndex) + heap::bytes(this->convertible);
+}
+
+auto TypeRegistry::functionsMemoryUsage() const -> std::size_t {
+	return heap::bytes(this->_functions) + heap::bytes(this->boundTypes);
+}
@@ -17,11 +17,19 @@ bool TypeVar::operator<(const TypeVar& other) const noexcept {
 	return this->_symbol < other._symbol;
 }
 
+auto TypeVar::operator==(std::string_view symbol) const noexcept -> bool {
+	return this->_symbol == symbol;
+}
+
+auto TypeVar::operator!=(std::string_view symbol) const noexcept -> bool {
+	return !(*this == symbol);
+}
+
 void TypeVar::CopyFrom(const TypeVar& other) {
-	this->_symbol = other.symbol();
+	this->_symbol = other._symbol;
 }
 
-auto TypeVar::symbol() const -> std::string {
+auto TypeVar::symbol() const noexcept -> const std::string& {
 	return this->_symbol;
 }
 
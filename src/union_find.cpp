@@ -0,0 +1,46 @@
+#include "typecheck/union_find.hpp"
+
+#include <utility>  // for swap
+
+using namespace typecheck;
+
+auto UnionFind::add() -> value_type {
+	this->parent.push_back(this->parent.size());
+	this->setSize.push_back(1);
+	return this->parent.size() - 1;
+}
+
+auto UnionFind::find(const value_type i) -> value_type {
+	auto root = i;
+	while (this->parent.at(root) != root) {
+		root = this->parent.at(root);
+	}
+
+	// Point everything on the path directly at the root.
+	auto curr = i;
+	while (this->parent.at(curr) != root) {
+		const auto next = this->parent.at(curr);
+		this->parent.at(curr) = root;
+		curr = next;
+	}
+	return root;
+}
+
+auto UnionFind::unite(const value_type a, const value_type b) -> bool {
+	auto rootA = this->find(a);
+	auto rootB = this->find(b);
+	if (rootA == rootB) {
+		return false;
+	}
+
+	if (this->setSize.at(rootA) < this->setSize.at(rootB)) {
+		std::swap(rootA, rootB);
+	}
+	this->parent.at(rootB) = rootA;
+	this->setSize.at(rootA) += this->setSize.at(rootB);
+	return true;
+}
+
+auto UnionFind::size() const -> std::size_t {
+	return this->parent.size();
+}
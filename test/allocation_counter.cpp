@@ -0,0 +1,50 @@
+//
+//  allocation_counter.cpp
+//  bench_typecheck
+//
+//  Replaces the global allocation functions, only link into the benchmarks.
+//
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+	thread_local std::size_t numAllocations = 0;
+
+	void* CountedAllocate(std::size_t size) {
+		++numAllocations;
+		if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+			return ptr;
+		}
+		throw std::bad_alloc();
+	}
+}
+
+auto bench::allocations() noexcept -> std::size_t {
+	return numAllocations;
+}
+
+void* operator new(std::size_t size) {
+	return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+	return CountedAllocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
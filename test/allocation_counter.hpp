@@ -0,0 +1,25 @@
+//
+//  allocation_counter.hpp
+//  bench_typecheck
+//
+#pragma once
+
+#include <cstddef>
+
+namespace bench {
+	// Calls to the global `operator new` made by this thread so far.
+	std::size_t allocations() noexcept;
+
+	// Counts the allocations made by this thread while in scope.
+	class AllocationScope {
+	public:
+		AllocationScope() : start(allocations()) {}
+
+		std::size_t count() const noexcept {
+			return allocations() - this->start;
+		}
+
+	private:
+		std::size_t start;
+	};
+}
@@ -0,0 +1,110 @@
+//
+//  bench_type_manager.cpp
+//  bench_typecheck
+//
+#include "test_include_catch.hpp"
+#include "allocation_counter.hpp"
+
+#include <sys/resource.h>
+
+#include <iostream>
+
+namespace {
+    // Most memory resident at once in this process so far.
+    std::size_t PeakRSS() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+    }
+}
+
+TEST_CASE("isConvertible does not allocate", "[benchmark]") {
+    getDefaultTypeManager(tm);
+    const std::string intName = "int";
+    const std::string doubleName = "double";
+    const auto intType = tm.getRegisteredType(intName);
+    const auto doubleType = tm.getRegisteredType(doubleName);
+
+    std::size_t allocations = 0;
+    {
+        bench::AllocationScope scope;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            tm.isConvertible(intName, doubleName);
+            tm.isConvertible(doubleName, intName);
+            tm.isConvertible(intType, doubleType);
+            tm.hasRegisteredType(intName);
+        }
+        allocations = scope.count();
+    }
+    CHECK(allocations == 0);
+
+    BENCHMARK("isConvertible(string, string)") {
+        return tm.isConvertible(intName, doubleName);
+    };
+
+    BENCHMARK("isConvertible(Type, Type)") {
+        return tm.isConvertible(intType, doubleType);
+    };
+
+    BENCHMARK("hasRegisteredType(string)") {
+        return tm.hasRegisteredType(doubleName);
+    };
+}
+
+TEST_CASE("register a large prelude", "[benchmark]") {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        names.push_back("prelude_type_" + std::to_string(i));
+    }
+
+    BENCHMARK("registerTypes, 20k types") {
+        typecheck::TypeManager tm;
+        return tm.registerTypes(names);
+    };
+
+    BENCHMARK("registerType, 20k types") {
+        typecheck::TypeManager tm;
+        for (const auto& name : names) {
+            tm.registerType(name);
+        }
+        return tm.hasRegisteredType(names.back());
+    };
+}
+
+TEST_CASE("load a prelude snapshot", "[benchmark]") {
+    typecheck::TypeRegistry prelude;
+    for (std::size_t i = 0; i < 20000; ++i) {
+        prelude.registerType("prelude_type_" + std::to_string(i));
+        if (i > 0) {
+            prelude.setConvertible("prelude_type_" + std::to_string(i - 1), "prelude_type_" + std::to_string(i));
+        }
+    }
+    const auto snapshot = prelude.serialize();
+
+    BENCHMARK("unserialize, 20k types and conversions") {
+        return typecheck::TypeRegistry::unserialize(snapshot).has_value();
+    };
+}
+
+TEST_CASE("memory per constraint", "[benchmark]") {
+    for (const std::size_t numSymbols : {1000, 10000, 100000}) {
+        getDefaultTypeManager(tm);
+        CreateStressSystem(tm, numSymbols);
+        REQUIRE(tm.solve().has_value());
+
+        const auto usage = tm.memoryUsage();
+        const auto numConstraints = tm.constraints.size();
+        std::cout << "stress " << numSymbols << ": " << usage.total() / numConstraints << " bytes per constraint ("
+                  << usage.constraints / numConstraints << " constraints, " << usage.typeVars / numConstraints << " type vars, "
+                  << usage.solverWorkspace / numConstraints << " workspace, " << usage.result / numConstraints << " result), peak RSS "
+                  << PeakRSS() / (1024 * 1024) << " MiB" << std::endl;
+
+        // Symbols are short enough to be stored inline, so a constraint should be little more than its `sizeof`.
+        CHECK(usage.constraints <= 2 * numConstraints * sizeof(typecheck::Constraint));
+        CHECK(usage.total() <= 64 * numConstraints * sizeof(typecheck::Constraint));
+    }
+}
@@ -0,0 +1,5 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "test_include_catch.hpp"
+#include "allocation_counter.hpp"
+
+#include "bench_type_manager.cpp"
@@ -0,0 +1,220 @@
+//
+//  scale_typecheck.cpp
+//  scale_typecheck
+//
+//  How `solve()` grows with the number of variables, up to 10^6, for a few shapes of constraint system.
+//  Slow, so only run through `ctest -L perf`. Set `TYPECHECK_SCALING_MAX_VARS` to stop at fewer variables.
+//  The limits assume the default Debug build. Optimized, the solve spends most of its time waiting on memory past 10^5 variables,
+//  which fits an exponent near 1.4 even for linear work.
+//
+#include "test_include_catch.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <random>
+
+namespace {
+    using Topology = std::function<void(typecheck::TypeManager&, const std::vector<typecheck::TypeVar>&)>;
+
+    // Alternating conversions and equalities, from a literal at the start.
+    void Chain(typecheck::TypeManager& tm, const std::vector<typecheck::TypeVar>& T) {
+        tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+        for (std::size_t i = 0; i + 1 < T.size(); ++i) {
+            if (i % 2 == 0) {
+                tm.CreateConvertibleConstraint(T.at(i), T.at(i + 1));
+            } else {
+                tm.CreateEqualsConstraint(T.at(i), T.at(i + 1));
+            }
+        }
+    }
+
+    // Binary tree of conversions from a literal at the root, some leaves bound.
+    void Tree(typecheck::TypeManager& tm, const std::vector<typecheck::TypeVar>& T) {
+        tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+        const auto doubleType = tm.getRegisteredType("double");
+        for (std::size_t i = 1; i < T.size(); ++i) {
+            tm.CreateConvertibleConstraint(T.at((i - 1) / 2), T.at(i));
+            if (2 * i + 1 >= T.size() && i % 7 == 0) {
+                tm.CreateBindToConstraint(T.at(i), doubleType);
+            }
+        }
+    }
+
+    // Square grid, equal along each row and converting down each column.
+    void Grid(typecheck::TypeManager& tm, const std::vector<typecheck::TypeVar>& T) {
+        const auto width = static_cast<std::size_t>(std::sqrt(static_cast<double>(T.size())));
+        tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+        for (std::size_t row = 0; row < width; ++row) {
+            for (std::size_t col = 0; col < width; ++col) {
+                const auto i = row * width + col;
+                if (col + 1 < width) {
+                    tm.CreateEqualsConstraint(T.at(i), T.at(i + 1));
+                }
+                if (row + 1 < width) {
+                    tm.CreateConvertibleConstraint(T.at(i), T.at(i + width));
+                }
+            }
+        }
+    }
+
+    // Calls to an overloaded function, each with an integer literal or the result of the call before as its arg.
+    // The choice of overload keeps it off the lattice, so this times the satisfiability search, its overload tables and defaulting the literals.
+    // The two-arg overload is pruned from every call.
+    void Overloads(typecheck::TypeManager& tm, const std::vector<typecheck::TypeVar>& T) {
+        const auto f = tm.CreateFunctionHash("f", {"x"});
+        for (const auto* name : {"int", "float", "double"}) {
+            tm.CreateApplicableFunctionConstraint(f, {tm.getRegisteredType(name)}, tm.getRegisteredType(name));
+        }
+        tm.CreateApplicableFunctionConstraint(f, {tm.getRegisteredType("int"), tm.getRegisteredType("int")}, tm.getRegisteredType("int"));
+
+        for (std::size_t i = 0; i + 2 < T.size(); i += 3) {
+            tm.CreateBindFunctionConstraint(f, T.at(i), {T.at(i + 1)}, T.at(i + 2));
+            if (i % 2 == 0) {
+                tm.CreateLiteralConformsToConstraint(T.at(i + 1), typecheck::KnownProtocolKind::ExpressibleByInteger);
+            } else {
+                tm.CreateConvertibleConstraint(T.at(i - 1), T.at(i + 1));
+            }
+        }
+    }
+
+    // Two constraints per variable between random pairs, the same for every run.
+    void RandomSparse(typecheck::TypeManager& tm, const std::vector<typecheck::TypeVar>& T) {
+        std::mt19937_64 rng(T.size());
+        std::uniform_int_distribution<std::size_t> pick(0, T.size() - 1);
+        for (std::size_t i = 0; i < 2 * T.size(); ++i) {
+            auto a = pick(rng);
+            auto b = pick(rng);
+            if (a == b) {
+                continue;
+            }
+            if (a > b) {
+                std::swap(a, b);
+            }
+
+            if (i % 2 == 0) {
+                tm.CreateConvertibleConstraint(T.at(a), T.at(b));
+            } else {
+                tm.CreateEqualsConstraint(T.at(a), T.at(b));
+            }
+            if (i % 97 == 0) {
+                tm.CreateLiteralConformsToConstraint(T.at(a), typecheck::KnownProtocolKind::ExpressibleByInteger);
+            }
+        }
+    }
+
+    auto MaxVars() -> std::size_t {
+        const auto* max = std::getenv("TYPECHECK_SCALING_MAX_VARS");
+        return max != nullptr ? std::strtoull(max, nullptr, 10) : 1000000;
+    }
+
+    // 10^4 to the max, in steps of sqrt(10).
+    auto Sizes() -> std::vector<std::size_t> {
+        std::vector<std::size_t> sizes;
+        for (double n = 1e4; n <= static_cast<double>(MaxVars()) * 1.01; n *= std::sqrt(10.0)) {
+            sizes.push_back(static_cast<std::size_t>(n));
+        }
+        return sizes;
+    }
+
+    // Small sizes are timed a few times, to smooth out the noise.
+    auto Repeats(const std::size_t n) -> std::size_t {
+        return n <= 100000 ? 3 : 1;
+    }
+
+    // Seconds for the fastest of the repeats, checking each takes the expected path.
+    auto TimeSolve(const Topology& topology, const std::size_t n, const typecheck::SolveStats::Path path) -> double {
+        // None of these backtrack, but the satisfiability search still visits a node per variable, so the default limit would hand the larger systems to the optimizing search.
+        typecheck::SolveOptions options;
+        options.nodeLimit = std::numeric_limits<std::size_t>::max();
+
+        auto best = std::numeric_limits<double>::max();
+        for (std::size_t i = 0; i < Repeats(n); ++i) {
+            typecheck::TypeManager tm;
+            setupTypeManager(&tm);
+            topology(tm, CreateMultipleSymbols(tm, n));
+
+            const auto start = std::chrono::steady_clock::now();
+            REQUIRE(tm.solve(options).has_value());
+            const auto solved = std::chrono::steady_clock::now();
+            REQUIRE(tm.getStats().path == path);
+            best = std::min(best, std::chrono::duration<double>(solved - start).count());
+        }
+        return best;
+    }
+
+    // Least squares fit of `times = c * sizes^k`, returns `k`.
+    auto FitExponent(const std::vector<double>& sizes, const std::vector<double>& times) -> double {
+        double meanX = 0;
+        double meanY = 0;
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            meanX += std::log(sizes.at(i)) / static_cast<double>(sizes.size());
+            meanY += std::log(times.at(i)) / static_cast<double>(sizes.size());
+        }
+
+        double covariance = 0;
+        double variance = 0;
+        for (std::size_t i = 0; i < sizes.size(); ++i) {
+            const auto x = std::log(sizes.at(i)) - meanX;
+            covariance += x * (std::log(times.at(i)) - meanY);
+            variance += x * x;
+        }
+        return covariance / variance;
+    }
+
+    // Every topology here should solve in linear time, which fits an exponent near 1, and quadratic near 2.
+    // Leaves room for `n log n` (about 1.1 over these sizes), the noise of timing a single run, and the caches running out, so growth of n^1.25 or worse fails.
+    constexpr double LINEAR = 1.25;
+
+    // Random pairs touch memory all over, so feel the caches running out more.
+    constexpr double LINEAR_RANDOM_ACCESS = 1.3;
+
+    void CheckScaling(const std::string& name, const Topology& topology, const typecheck::SolveStats::Path path, const double maxExponent) {
+        const auto sizes = Sizes();
+        REQUIRE(sizes.size() >= 3);
+
+        std::vector<double> ns;
+        std::vector<double> times;
+        for (const auto& n : sizes) {
+            const auto time = TimeSolve(topology, n, path);
+            ns.push_back(static_cast<double>(n));
+            times.push_back(time);
+            std::cout << name << " " << n << " vars: " << time * 1000 << " ms" << std::endl;
+        }
+
+        const auto exponent = FitExponent(ns, times);
+        std::cout << name << ": time ~ n^" << exponent << std::endl;
+        INFO(name << " grows as n^" << exponent);
+        CHECK(exponent < maxExponent);
+    }
+}
+
+TEST_CASE("complexity fit", "[perf]") {
+    const std::vector<double> sizes = {1e4, 1e5, 1e6};
+    CHECK(FitExponent(sizes, {1, 10, 100}) == Approx(1.0));
+    CHECK(FitExponent(sizes, {1, 100, 10000}) == Approx(2.0));
+    CHECK(FitExponent(sizes, {1e4 * std::log(1e4), 1e5 * std::log(1e5), 1e6 * std::log(1e6)}) < LINEAR);
+    CHECK(FitExponent(sizes, {1e4 * std::sqrt(1e4), 1e5 * std::sqrt(1e5), 1e6 * std::sqrt(1e6)}) > LINEAR_RANDOM_ACCESS);
+}
+
+TEST_CASE("chain scales linearly", "[perf]") {
+    CheckScaling("chain", Chain, typecheck::SolveStats::Lattice, LINEAR);
+}
+
+TEST_CASE("tree scales linearly", "[perf]") {
+    CheckScaling("tree", Tree, typecheck::SolveStats::Lattice, LINEAR);
+}
+
+TEST_CASE("grid scales linearly", "[perf]") {
+    CheckScaling("grid", Grid, typecheck::SolveStats::Lattice, LINEAR);
+}
+
+TEST_CASE("random sparse scales linearly", "[perf]") {
+    CheckScaling("random sparse", RandomSparse, typecheck::SolveStats::Lattice, LINEAR_RANDOM_ACCESS);
+}
+
+TEST_CASE("overloads scale linearly", "[perf]") {
+    CheckScaling("overloads", Overloads, typecheck::SolveStats::Defaulted, LINEAR);
+}
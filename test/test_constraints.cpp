@@ -16,6 +16,89 @@ TEST_CASE("test resolve bindto conflicting full", "[constraints]") {
     REQUIRE(!tm.solve());
 }
 
+TEST_CASE("test resolve bindto conflicting through equals chain", "[constraints]") {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 40);
+
+    tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+    for (std::size_t i = 1; i < T.size(); ++i) {
+        tm.CreateEqualsConstraint(T.at(i - 1), T.at(i));
+        tm.CreateLiteralConformsToConstraint(T.at(i), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    }
+    tm.CreateBindToConstraint(T.at(T.size() - 1), tm.getRegisteredType("float"));
+
+    REQUIRE(!tm.solve());
+}
+
+TEST_CASE("test consistency bindto conflicting through equals", "[constraints]") {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 4);
+
+    const auto bindInt = tm.CreateBindToConstraint(T.at(0), tm.getRegisteredType("int"));
+    const auto equals1 = tm.CreateEqualsConstraint(T.at(0), T.at(1));
+    const auto equals2 = tm.CreateEqualsConstraint(T.at(2), T.at(1));
+    const auto unrelated = tm.CreateEqualsConstraint(T.at(2), T.at(3));
+    const auto bindFloat = tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("float"));
+
+    const auto report = tm.checkConsistency();
+    REQUIRE(!report.consistent());
+    const auto& ids = report.conflicting();
+    CHECK(std::find(ids.begin(), ids.end(), bindInt) != ids.end());
+    CHECK(std::find(ids.begin(), ids.end(), bindFloat) != ids.end());
+    CHECK(std::find(ids.begin(), ids.end(), equals1) != ids.end());
+    CHECK(std::find(ids.begin(), ids.end(), equals2) != ids.end());
+    CHECK(std::find(ids.begin(), ids.end(), unrelated) == ids.end());
+
+    REQUIRE(!tm.solve());
+    CHECK(!tm.getConflict().consistent());
+}
+
+TEST_CASE("test consistency literal outside protocol", "[constraints]") {
+    getDefaultTypeManager(tm);
+    auto T1 = tm.CreateTypeVar();
+    auto T2 = tm.CreateTypeVar();
+
+    const auto literal = tm.CreateLiteralConformsToConstraint(T1, typecheck::KnownProtocolKind::ExpressibleByFloat);
+    const auto equals = tm.CreateEqualsConstraint(T1, T2);
+    const auto bind = tm.CreateBindToConstraint(T2, tm.getRegisteredType("int"));
+
+    const auto report = tm.checkConsistency();
+    REQUIRE(!report.consistent());
+    const auto& ids = report.conflicting();
+    CHECK(ids.size() == 3);
+    CHECK(std::find(ids.begin(), ids.end(), literal) != ids.end());
+    CHECK(std::find(ids.begin(), ids.end(), equals) != ids.end());
+    CHECK(std::find(ids.begin(), ids.end(), bind) != ids.end());
+}
+
+TEST_CASE("test consistency impossible conversion", "[constraints]") {
+    getDefaultTypeManager(tm);
+    auto T1 = tm.CreateTypeVar();
+    auto T2 = tm.CreateTypeVar();
+
+    tm.CreateBindToConstraint(T1, tm.getRegisteredType("double"));
+    tm.CreateBindToConstraint(T2, tm.getRegisteredType("float"));
+    const auto conversion = tm.CreateConvertibleConstraint(T1, T2);
+
+    const auto report = tm.checkConsistency();
+    CHECK(!report.consistent());
+    CHECK(std::find(report.conflicting().begin(), report.conflicting().end(), conversion) != report.conflicting().end());
+}
+
+TEST_CASE("test consistency solvable system", "[constraints]") {
+    getDefaultTypeManager(tm);
+    auto T1 = tm.CreateTypeVar();
+    auto T2 = tm.CreateTypeVar();
+
+    tm.CreateLiteralConformsToConstraint(T1, typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateLiteralConformsToConstraint(T2, typecheck::KnownProtocolKind::ExpressibleByFloat);
+    tm.CreateEqualsConstraint(T1, T2);
+
+    CHECK(tm.checkConsistency().consistent());
+    REQUIRE(tm.solve().has_value());
+    CHECK(tm.getConflict().consistent());
+}
+
 TEST_CASE("solve basic type int equals constraint", "[constraint]") {
     getDefaultTypeManager(tm);
 
@@ -68,6 +151,32 @@ TEST_CASE("solve basic type equals mutally recursive constraint", "[constraint]"
 
     const auto solution = tm.solve();
     REQUIRE(solution.has_value());
+    CHECK(tm.getStats().simplified == 1);
+}
+
+TEST_CASE("solve drops duplicate and trivial constraints", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    auto T1 = tm.CreateTypeVar();
+    auto T2 = tm.CreateTypeVar();
+    auto T3 = tm.CreateTypeVar();
+
+    tm.CreateLiteralConformsToConstraint(T1, typecheck::KnownProtocolKind::ExpressibleByFloat);
+    tm.CreateEqualsConstraint(T1, T2);
+    tm.CreateEqualsConstraint(T1, T2);
+    tm.CreateEqualsConstraint(T3, T3);
+    tm.CreateConvertibleConstraint(T2, T2);
+    tm.CreateBindToConstraint(T2, tm.getRegisteredType("float"));
+    tm.CreateBindToConstraint(T2, tm.getRegisteredType("float"));
+
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+    CHECK(tm.getStats().constraints == 7);
+    CHECK(tm.getStats().simplified == 4);
+    CHECK(solution->getResolvedType(T2).raw().name() == "float");
+
+    // Still resolved, even though nothing constrains it any more.
+    CHECK(solution->hasResolvedType(T3));
 }
 
 TEST_CASE("solve basic type equals triangle constraint", "[constraint]") {
@@ -174,6 +283,42 @@ TEST_CASE("solve convertible conversion explicit constraint", "[constraint]") {
     CHECK(solution->getResolvedType(T2).raw().name() == "float");
 }
 
+TEST_CASE("solve conversions without searching", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 5);
+
+    // int literal -> T1 == T2 -> float literal, double literal -> T4
+    tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+    tm.CreateEqualsConstraint(T.at(1), T.at(2));
+    tm.CreateConvertibleConstraint(T.at(2), T.at(3));
+    tm.CreateLiteralConformsToConstraint(T.at(3), typecheck::KnownProtocolKind::ExpressibleByFloat);
+    tm.CreateLiteralConformsToConstraint(T.at(4), typecheck::KnownProtocolKind::ExpressibleByDouble);
+    tm.CreateConvertibleConstraint(T.at(4), T.at(2));
+
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+    CHECK(tm.getStats().path == typecheck::SolveStats::Lattice);
+    CHECK(solution->getResolvedType(T.at(0)).raw().name() == "int");
+    CHECK(solution->getResolvedType(T.at(1)).raw().name() == "double");
+    CHECK(solution->getResolvedType(T.at(2)).raw().name() == "double");
+    CHECK(solution->getResolvedType(T.at(4)).raw().name() == "double");
+
+    // Just as good as searching.
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    const auto searched = tm.solve(options);
+    REQUIRE(searched.has_value());
+    CHECK(tm.getStats().path == typecheck::SolveStats::Search);
+    CHECK(searched->getResolvedType(T.at(0)).raw().name() == "int");
+    CHECK(searched->getResolvedType(T.at(4)).raw().name() == "double");
+
+    // double doesn't convert to float, so the float literal can't be one.
+    CHECK(solution->getResolvedType(T.at(3)).raw().name() == "double");
+    CHECK(searched->getResolvedType(T.at(3)).raw().name() == "double");
+}
+
 TEST_CASE("solve function application constraint", "[constraint]") {
     getDefaultTypeManager(tm);
 
@@ -225,6 +370,44 @@ TEST_CASE("solve inferred function application constraint", "[constraint]") {
     CHECK(solution->getResolvedType(T.at(3)).raw().name() == "double");
 }
 
+TEST_CASE("solve single overload by unification", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 7);
+
+    const auto T0FuncHash = std::hash<std::string>()(T.at(0).symbol());
+    tm.CreateApplicableFunctionConstraint(T0FuncHash, {T.at(1), T.at(2)}, T.at(3));
+    tm.CreateBindFunctionConstraint(T0FuncHash, T.at(0), {T.at(4), T.at(5)}, T.at(6));
+
+    // Only one overload, so the args come from the call site.
+    tm.CreateLiteralConformsToConstraint(T.at(4), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateLiteralConformsToConstraint(T.at(5), typecheck::KnownProtocolKind::ExpressibleByDouble);
+    tm.CreateEqualsConstraint(T.at(3), T.at(5));
+
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+    CHECK(tm.getStats().path == typecheck::SolveStats::Unification);
+
+    const auto resolved = solution->getResolvedType(T.at(0));
+    REQUIRE(resolved.has_func());
+    const auto& func = resolved.func();
+    REQUIRE(func.args_size() == 2);
+    CHECK(func.args(0).raw().name() == "int");
+    CHECK(func.args(1).raw().name() == "double");
+    CHECK(func.returntype().raw().name() == "double");
+    CHECK(solution->getResolvedType(T.at(6)).raw().name() == "double");
+
+    // Same answer as searching.
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    const auto searched = tm.solve(options);
+    REQUIRE(searched.has_value());
+    CHECK(tm.getStats().path == typecheck::SolveStats::Search);
+    for (const auto& var : T) {
+        CHECK(searched->getResolvedType(var).ShortDebugString() == solution->getResolvedType(var).ShortDebugString());
+    }
+}
+
 TEST_CASE("solve inferred function application constraint no args", "[constraint]") {
     getDefaultTypeManager(tm);
 
@@ -283,6 +466,57 @@ TEST_CASE("solve function different num args application constraint", "[constrai
     CHECK(solution->getResolvedType(T.at(2)).raw().name() == "double");
 }
 
+TEST_CASE("solve overloads with different num args without searching", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 3);
+
+    // func foo(a: Int, b: Float) -> Double, func foo(a: Int) -> Double
+    const auto fooHash = tm.CreateFunctionHash("foo", {});
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("int"), tm.getRegisteredType("float") }, tm.getRegisteredType("double"));
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("int") }, tm.getRegisteredType("double"));
+
+    tm.CreateBindFunctionConstraint(fooHash, T.at(0), { T.at(1) }, T.at(2));
+
+    // Only one overload takes a single arg, so there's nothing to choose.
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+    CHECK(tm.getStats().prunedOverloads == 1);
+    CHECK(tm.getStats().path == typecheck::SolveStats::Unification);
+    REQUIRE(solution->getResolvedType(T.at(0)).has_func());
+    CHECK(solution->getResolvedType(T.at(0)).func().args_size() == 1);
+    CHECK(solution->getResolvedType(T.at(1)).raw().name() == "int");
+    CHECK(solution->getResolvedType(T.at(2)).raw().name() == "double");
+}
+
+TEST_CASE("solve overloads discriminated by bound arg types", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 3);
+
+    // func foo(a: Int) -> Int, func foo(a: Float) -> Double
+    const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("int") }, tm.getRegisteredType("int"));
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("float") }, tm.getRegisteredType("double"));
+
+    tm.CreateBindFunctionConstraint(fooHash, T.at(0), { T.at(1) }, T.at(2));
+    tm.CreateBindToConstraint(T.at(1), tm.getRegisteredType("float"));
+
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+    CHECK(tm.getStats().prunedOverloads == 1);
+    CHECK(tm.getStats().path == typecheck::SolveStats::Unification);
+    CHECK(solution->getResolvedType(T.at(2)).raw().name() == "double");
+
+    // The search only sees the one that's left.
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    const auto searched = tm.solve(options);
+    REQUIRE(searched.has_value());
+    CHECK(tm.getStats().prunedOverloads == 1);
+    CHECK(searched->getResolvedType(T.at(2)).raw().name() == "double");
+}
+
 TEST_CASE("solve function same num args different types application constraint", "[constraint]") {
     getDefaultTypeManager(tm);
 
@@ -316,6 +550,155 @@ TEST_CASE("solve function same num args different types application constraint",
 
     CHECK(solution->getResolvedType(T.at(1)).raw().name() == "int");
     CHECK(solution->getResolvedType(T.at(2)).raw().name() == "double");
+    CHECK(tm.getStats().path == typecheck::SolveStats::Defaulted);
+}
+
+TEST_CASE("solve function literal defaults float equals constraint", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 4);
+
+    // func foo(a: Int) -> Double
+    tm.CreateApplicableFunctionConstraint(tm.CreateFunctionHash("foo", {"a"}), { tm.getRegisteredType("int") }, tm.getRegisteredType("double"));
+
+    // func foo(a: Float) -> Double
+    tm.CreateApplicableFunctionConstraint(tm.CreateFunctionHash("foo", {"a"}), { tm.getRegisteredType("float") }, tm.getRegisteredType("double"));
+
+    // int can never satisfy the float literal, so only T3 gets its preferred type (like "solve basic type float equals constraint").
+    tm.CreateBindFunctionConstraint(tm.CreateFunctionHash("foo", {"a"}), T.at(0), { T.at(1) }, T.at(2));
+    tm.CreateLiteralConformsToConstraint(T.at(1), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateLiteralConformsToConstraint(T.at(3), typecheck::KnownProtocolKind::ExpressibleByFloat);
+    tm.CreateEqualsConstraint(T.at(1), T.at(3));
+
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+    CHECK(tm.getStats().path == typecheck::SolveStats::Defaulted);
+    REQUIRE(solution->getResolvedType(T.at(0)).has_func());
+    REQUIRE(solution->getResolvedType(T.at(0)).func().args_size() == 1);
+    CHECK(solution->getResolvedType(T.at(0)).func().args(0).raw().name() == "float");
+    CHECK(solution->getResolvedType(T.at(1)).raw().name() == "float");
+    CHECK(solution->getResolvedType(T.at(3)).raw().name() == "float");
+}
+
+TEST_CASE("solve function literal defaults with a node limit", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 11);
+    const auto fooHash = tm.CreateFunctionHash("foo", {"a", "b"});
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("float"), tm.getRegisteredType("float") }, tm.getRegisteredType("float"));
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("double"), tm.getRegisteredType("float") }, tm.getRegisteredType("double"));
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("double"), tm.getRegisteredType("double") }, tm.getRegisteredType("float"));
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("int"), tm.getRegisteredType("double") }, tm.getRegisteredType("float"));
+
+    tm.CreateBindFunctionConstraint(fooHash, T.at(8), { T.at(2), T.at(1) }, T.at(10));
+    tm.CreateConvertibleConstraint(T.at(6), T.at(3));
+    tm.CreateEqualsConstraint(T.at(5), T.at(0));
+    tm.CreateConvertibleConstraint(T.at(4), T.at(6));
+    tm.CreateLiteralConformsToConstraint(T.at(10), typecheck::KnownProtocolKind::ExpressibleByFloat);
+    tm.CreateLiteralConformsToConstraint(T.at(3), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateConvertibleConstraint(T.at(2), T.at(1));
+    tm.CreateEqualsConstraint(T.at(4), T.at(1));
+    tm.CreateLiteralConformsToConstraint(T.at(2), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateLiteralConformsToConstraint(T.at(9), typecheck::KnownProtocolKind::ExpressibleByFloat);
+
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+
+    // With about 50 nodes the first search finishes but defaulting runs out, which must fall back to the optimizing search.
+    for (std::size_t limit = 1; limit <= 64; ++limit) {
+        INFO("node limit " << limit);
+        typecheck::SolveOptions options;
+        options.nodeLimit = limit;
+        const auto limited = tm.solve(options);
+        REQUIRE(limited.has_value());
+        for (const auto& var : T) {
+            CHECK(limited->getResolvedType(var) == solution->getResolvedType(var));
+        }
+    }
+}
+
+TEST_CASE("solve operator with an overload per type", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 4);
+    const auto plus = tm.CreateFunctionHash("+", {"lhs", "rhs"});
+    for (const auto& name : {"int", "float", "double"}) {
+        tm.CreateApplicableFunctionConstraint(plus, {tm.getRegisteredType(name), tm.getRegisteredType(name)}, tm.getRegisteredType(name));
+    }
+
+    // 1 + 2.0
+    tm.CreateBindFunctionConstraint(plus, T.at(0), {T.at(1), T.at(2)}, T.at(3));
+    tm.CreateLiteralConformsToConstraint(T.at(1), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateLiteralConformsToConstraint(T.at(2), typecheck::KnownProtocolKind::ExpressibleByFloat);
+
+    for (const auto fastPaths : {true, false}) {
+        typecheck::SolveOptions options;
+        options.fastPaths = fastPaths;
+        const auto solution = tm.solve(options);
+        REQUIRE(solution.has_value());
+
+        const auto func = solution->getResolvedType(T.at(0));
+        REQUIRE(func.has_func());
+        REQUIRE(func.func().args_size() == 2);
+        CHECK(func.func().args(0).raw().name() == "float");
+        CHECK(func.func().returntype().raw().name() == "float");
+        CHECK(solution->getResolvedType(T.at(1)).raw().name() == "float");
+        CHECK(solution->getResolvedType(T.at(3)).raw().name() == "float");
+    }
+}
+
+TEST_CASE("solve with hints", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 5);
+    tm.CreateEqualsConstraint(T.at(0), T.at(1));
+
+    // func foo(a: Int) -> Int, func foo(a: Float) -> Float
+    const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("int") }, tm.getRegisteredType("int"));
+    tm.CreateApplicableFunctionConstraint(fooHash, { tm.getRegisteredType("float") }, tm.getRegisteredType("float"));
+    tm.CreateBindFunctionConstraint(fooHash, T.at(2), { T.at(3) }, T.at(4));
+
+    // Nothing to choose between any of them, so the hints decide.
+    typecheck::SolveOptions options;
+    options.warmStart = true;
+    options.hints[T.at(0).symbol()] = tm.getRegisteredType("double");
+    options.hints[T.at(3).symbol()] = tm.getRegisteredType("float");
+    const auto hinted = tm.solve(options);
+    REQUIRE(hinted.has_value());
+    CHECK(tm.getStats().path == typecheck::SolveStats::Defaulted);
+    CHECK(hinted->getResolvedType(T.at(1)).raw().name() == "double");
+    CHECK(hinted->getResolvedType(T.at(4)).raw().name() == "float");
+
+    // Starts from the last solution.
+    options.hints.clear();
+    const auto warm = tm.solve(options);
+    REQUIRE(warm.has_value());
+    CHECK(warm->getResolvedType(T.at(1)).raw().name() == "double");
+    CHECK(warm->getResolvedType(T.at(4)).raw().name() == "float");
+
+    // Explicit hints win over the last solution.
+    options.hints[T.at(0).symbol()] = tm.getRegisteredType("float");
+    options.hints[T.at(3).symbol()] = tm.getRegisteredType("int");
+    const auto changed = tm.solve(options);
+    REQUIRE(changed.has_value());
+    CHECK(changed->getResolvedType(T.at(1)).raw().name() == "float");
+    CHECK(changed->getResolvedType(T.at(4)).raw().name() == "int");
+}
+
+TEST_CASE("solve ignores conflicting hints", "[constraint]") {
+    getDefaultTypeManager(tm);
+
+    const auto T = CreateMultipleSymbols(tm, 2);
+    tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateEqualsConstraint(T.at(0), T.at(1));
+
+    // A hint never makes the solution worse, the literal still gets its preferred type.
+    typecheck::SolveOptions options;
+    options.hints[T.at(1).symbol()] = tm.getRegisteredType("float");
+    const auto solution = tm.solve(options);
+    REQUIRE(solution.has_value());
+    CHECK(solution->getResolvedType(T.at(1)).raw().name() == "int");
 }
 
 TEST_CASE("solve function infer args later constraint", "[constraint]") {
@@ -692,23 +1075,7 @@ TEST_CASE("regression test 2 constraints (ackerman)", "[constraint]") {
 
 void RunStressTest(const std::size_t numSymbols) {
 	getDefaultTypeManager(tm);
-	tm.registerType("bool");
-	tm.registerType("void");
-
-	const auto T = CreateMultipleSymbols(tm, numSymbols);
-	const auto intType = tm.getRegisteredType("int");
-	const auto voidType = tm.getRegisteredType("void");
-	const auto boolType = tm.getRegisteredType("bool");
-
-	for (std::size_t i = 0; i < numSymbols; ++i) {
-		if (i % (numSymbols / 5) == 0) {
-			tm.CreateBindToConstraint(T.at(i), intType);
-		} else if (i % (numSymbols / 3) == 0) {
-			tm.CreateLiteralConformsToConstraint(T.at(i), typecheck::KnownProtocolKind::ExpressibleByInteger);
-		}
-
-		tm.CreateEqualsConstraint(T.at(i), T.at((i + 1) % numSymbols));
-	}
+	CreateStressSystem(tm, numSymbols);
 	const auto solution = tm.solve();
     REQUIRE(solution.has_value());
 }
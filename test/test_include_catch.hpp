@@ -6,9 +6,12 @@
 #include <string>
 #include <vector>
 #include <iostream>
-#include <algorithm>
+#include <algorithm>
+#include <thread>
 
 // Include pieces of the test
+#include <typecheck/batch_solver.hpp>
+
 #include "utils.hpp"
 
 #endif
\ No newline at end of file
@@ -1,5 +1,11 @@
 #include "test_include_catch.hpp"
 #include <typecheck/type.hpp>
+#include <typecheck/backjump_solver.hpp>
+#include <typecheck/overload_table.hpp>
+#include <typecheck/solver_observer.hpp>
+#include <typecheck/type_factory.hpp>
+
+#include <sstream>
 
 TEST_CASE("Check raw type copy constructor", "[raw_type]") {
 	typecheck::RawType t;
@@ -20,6 +26,66 @@ TEST_CASE("Check raw type equals", "[raw_type]") {
 	CHECK(g != t);
 }
 
+TEST_CASE("Check raw type and type var compare by name", "[raw_type]") {
+	const typecheck::RawType t("int");
+	CHECK(t == std::string_view("int"));
+	CHECK(t != std::string_view("float"));
+	CHECK(&t.name() == &t.name());
+
+	const typecheck::TypeVar v("T0");
+	CHECK(v == std::string_view("T0"));
+	CHECK(v != std::string_view("T1"));
+}
+
+TEST_CASE("Check function definition copies are independent", "[function definition]") {
+	typecheck::FunctionDefinition f;
+	f.set_name("foo");
+	auto* arg = f.add_args();
+	arg->mutable_raw()->set_name("int");
+	auto* ret = f.mutable_returntype();
+	ret->mutable_raw()->set_name("float");
+
+	// Pointers handed out before the copy only change the original.
+	typecheck::FunctionDefinition g{f};
+	CHECK(g == f);
+	arg->mutable_raw()->set_name("double");
+	ret->mutable_raw()->set_name("double");
+	CHECK(g.args(0).raw().name() == "int");
+	CHECK(g.returntype().raw().name() == "float");
+	CHECK(g != f);
+
+	g.add_args()->mutable_raw()->set_name("double");
+	CHECK(f.args_size() == 1);
+	CHECK(g.args_size() == 2);
+
+	typecheck::FunctionDefinition h;
+	h = f;
+	CHECK(h == f);
+	h = typecheck::FunctionDefinition{};
+	CHECK_FALSE(h.has_returntype());
+}
+
+TEST_CASE("Check type factory shares identical types", "[type_factory]") {
+	typecheck::TypeFactory factory;
+	const auto i = factory.raw("int");
+	CHECK(factory.raw("int") == i);
+	CHECK(factory.raw("float") != i);
+
+	const auto foo = factory.function("foo", 1, {i, i}, factory.raw("float"));
+	CHECK(factory.function("foo", 1, {i, i}, factory.raw("float")) == foo);
+	CHECK(factory.function("foo", 1, {i}, factory.raw("float")) != foo);
+	CHECK(factory.function("foo", 2, {i, i}, factory.raw("float")) != foo);
+	CHECK(foo.is_function());
+	CHECK(foo.type().func().args_size() == 2);
+	CHECK(std::hash<typecheck::TypeFactory::Ref>()(foo) == foo.hash());
+	CHECK(factory.size() == 5);
+
+	// Built up separately, still the same node.
+	CHECK(factory.intern(foo.type()) == foo);
+	CHECK(factory.size() == 5);
+	CHECK_FALSE(factory.intern(typecheck::Type()));
+}
+
 TEST_CASE("Check add args", "[function definition]") {
 	typecheck::FunctionDefinition f;
 	CHECK(f.args_size() == 0);
@@ -156,3 +222,210 @@ TEST_CASE("Copy Type Constructor", "[type]") {
 	CHECK(g.func().returntype().has_raw());
 	CHECK(g.func().returntype().raw().name() == "Hello world");
 }
+
+TEST_CASE("Backjump solver satisfiable", "[backjump_solver]") {
+	typecheck::BackjumpSolver solver;
+	const auto a = solver.addVariable({0, 1, 2});
+	const auto b = solver.addVariable({0, 1, 2});
+	solver.addConstraint(0, {a, b}, [a, b](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(a) + 1 == env.at(b);
+	});
+	solver.addConstraint(1, {b}, [b](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(b) == 2;
+	});
+
+	REQUIRE(solver.solve() == typecheck::BackjumpSolver::Satisfiable);
+	CHECK(solver.value(a) == 1);
+	CHECK(solver.value(b) == 2);
+}
+
+TEST_CASE("Backjump solver assumptions", "[backjump_solver]") {
+	typecheck::BackjumpSolver solver;
+	const auto a = solver.addVariable({0, 1, 2});
+	const auto b = solver.addVariable({0, 1, 2});
+	solver.addConstraint(0, {a, b}, [a, b](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(a) < env.at(b);
+	});
+
+	REQUIRE(solver.solve({{a, 1}}) == typecheck::BackjumpSolver::Satisfiable);
+	CHECK(solver.value(a) == 1);
+	CHECK(solver.value(b) == 2);
+	CHECK(solver.solve({{b, 0}}) == typecheck::BackjumpSolver::Unsatisfiable);
+	CHECK(solver.solve({{a, 3}}) == typecheck::BackjumpSolver::Unsatisfiable);
+
+	// Assumptions don't stick.
+	REQUIRE(solver.solve() == typecheck::BackjumpSolver::Satisfiable);
+	CHECK(solver.value(a) == 0);
+}
+
+TEST_CASE("Backjump solver jumps over unrelated variables", "[backjump_solver]") {
+	typecheck::BackjumpSolver solver;
+	const auto a = solver.addVariable({0, 1});
+	const auto b = solver.addVariable({0, 1, 2});
+	const auto c = solver.addVariable({0, 1, 2, 3});
+
+	// `b` is independent, exhausting `c` should jump straight back to `a`.
+	solver.addConstraint(0, {a, c}, [a, c](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(c) == env.at(a) + 2;
+	});
+	solver.addConstraint(1, {a, c}, [c](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(c) == 3;
+	});
+	solver.addConstraint(2, {b, c}, [](const typecheck::BackjumpSolver::Assignment&) {
+		return true;
+	});
+
+	REQUIRE(solver.solve() == typecheck::BackjumpSolver::Satisfiable);
+	CHECK(solver.value(a) == 1);
+	CHECK(solver.value(c) == 3);
+	CHECK(solver.stats().backjumps == 1);
+	CHECK(solver.stats().nogoods == 1);
+}
+
+TEST_CASE("Backjump solver unsatisfiable conflict", "[backjump_solver]") {
+	typecheck::BackjumpSolver solver;
+	const auto a = solver.addVariable({0, 1});
+	const auto b = solver.addVariable({0, 1});
+	const auto c = solver.addVariable({0, 1, 2, 3});
+	solver.addConstraint(7, {a, b}, [a, b](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(a) == env.at(b);
+	});
+	solver.addConstraint(8, {a, b}, [a, b](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(a) != env.at(b);
+	});
+	solver.addConstraint(9, {c}, [c](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(c) > 0;
+	});
+
+	REQUIRE(solver.solve() == typecheck::BackjumpSolver::Unsatisfiable);
+	const auto& conflict = solver.conflict();
+	CHECK(std::find(conflict.begin(), conflict.end(), 7) != conflict.end());
+	CHECK(std::find(conflict.begin(), conflict.end(), 8) != conflict.end());
+	CHECK(std::find(conflict.begin(), conflict.end(), 9) == conflict.end());
+}
+
+TEST_CASE("Overload table arc consistency", "[backjump_solver]") {
+	// Call `type(ret, arg)`, with overloads 10 = (int) -> int, 11 = (float) -> float and 12 = (int, int) -> int.
+	const std::size_t type = 0, ret = 1, arg = 2;
+	std::vector<std::vector<std::size_t>> domains{{10, 11, 12}, {0, 1}, {1}, {0}, {0}, {1}, {1}, {0}, {0}, {0}};
+	typecheck::OverloadTable table(type, {ret, arg});
+	table.add_row(10, {3, 4});
+	table.add_row(11, {5, 6});
+	table.add_row(12, {7, 8, 9});
+	table.add_row(10, {5, 6});
+
+	CHECK(table.rows().size() == 3);
+	CHECK(table.scope().size() == 10);
+
+	// Only the float overload takes a float.
+	std::vector<std::size_t> narrowed;
+	REQUIRE(table.propagate(domains, &narrowed));
+	CHECK(domains.at(type) == std::vector<std::size_t>{11});
+	CHECK(domains.at(ret) == std::vector<std::size_t>{1});
+	CHECK(narrowed.size() == 2);
+
+	const auto at = [&domains](const std::size_t var) {
+		return domains.at(var).front();
+	};
+	CHECK(table.satisfied(at));
+
+	domains.at(arg) = {2};
+	narrowed.clear();
+	CHECK_FALSE(table.propagate(domains, &narrowed));
+	CHECK(domains.at(type).empty());
+}
+
+TEST_CASE("Backjump solver overload table conflict", "[backjump_solver]") {
+	typecheck::BackjumpSolver solver;
+	const auto type = solver.addVariable({10});
+	const auto arg = solver.addVariable({0, 1});
+	const auto intArg = solver.addVariable({0});
+	const auto floatArg = solver.addVariable({1});
+	solver.addConstraint(1, {arg}, [arg](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(arg) == 1;
+	});
+
+	// Only the int overload is left, which can't take the float.
+	typecheck::OverloadTable table(type, {arg});
+	table.add_row(10, {intArg});
+	table.add_row(11, {floatArg});
+	solver.addTable(2, table);
+	REQUIRE(solver.solve() == typecheck::BackjumpSolver::Unsatisfiable);
+	CHECK(solver.stats().nodes == 0);
+	CHECK(std::find(solver.conflict().begin(), solver.conflict().end(), 2) != solver.conflict().end());
+
+	// Both overloads are possible, the table picks the float one before searching.
+
+	typecheck::BackjumpSolver satisfiable;
+	const auto type2 = satisfiable.addVariable({10, 11});
+	const auto arg2 = satisfiable.addVariable({0, 1});
+	satisfiable.addVariable({0});
+	satisfiable.addVariable({1});
+	satisfiable.addConstraint(1, {arg2}, [arg2](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(arg2) == 1;
+	});
+	satisfiable.addTable(2, table);
+	REQUIRE(satisfiable.solve() == typecheck::BackjumpSolver::Satisfiable);
+	CHECK(satisfiable.value(type2) == 11);
+	CHECK(satisfiable.stats().nodes == 4);
+}
+
+TEST_CASE("Backjump solver observers", "[backjump_solver]") {
+	typecheck::BackjumpSolver solver;
+	const auto a = solver.addVariable({0, 1});
+	const auto b = solver.addVariable({0, 1, 2});
+	const auto c = solver.addVariable({0, 1, 2, 3});
+	solver.addConstraint(0, {a, c}, [a, c](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(c) == env.at(a) + 2;
+	});
+	solver.addConstraint(1, {a, c}, [c](const typecheck::BackjumpSolver::Assignment& env) {
+		return env.at(c) == 3;
+	});
+	solver.addConstraint(2, {b, c}, [](const typecheck::BackjumpSolver::Assignment&) {
+		return true;
+	});
+
+	typecheck::CountingObserver counts;
+	REQUIRE(solver.search(counts) == typecheck::BackjumpSolver::Satisfiable);
+	CHECK(counts.expansions == solver.stats().nodes);
+	CHECK(counts.backjumps == solver.stats().backjumps);
+	CHECK(counts.backtracks >= counts.backjumps);
+	CHECK(counts.failures == counts.failuresByConstraint.at(0) + counts.failuresByConstraint.at(1));
+
+	std::ostringstream events;
+	typecheck::StreamObserver stream(events);
+	REQUIRE(solver.search(stream) == typecheck::BackjumpSolver::Satisfiable);
+	const auto log = events.str();
+	CHECK(static_cast<std::size_t>(std::count(log.begin(), log.end(), '\n')) == counts.expansions + counts.failures + counts.backtracks);
+	CHECK(log.rfind("expand ", 0) == 0);
+}
+
+TEST_CASE("Backjump solver observers see nogoods", "[backjump_solver]") {
+	// `c` and `d` can never hold together, which the search finds out once and then remembers as a nogood.
+	typecheck::BackjumpSolver solver;
+	const auto a = solver.addVariable({0, 1});
+	const auto b = solver.addVariable({0, 1});
+	const auto c = solver.addVariable({0, 1});
+	const auto d = solver.addVariable({0, 1});
+	std::size_t rejected = 0;
+	solver.addConstraint(0, {c, a}, [a, &rejected](const typecheck::BackjumpSolver::Assignment& env) {
+		rejected += env.at(a) == 1 ? 0 : 1;
+		return env.at(a) == 1;
+	});
+	solver.addConstraint(1, {d, b}, [b, d, &rejected](const typecheck::BackjumpSolver::Assignment& env) {
+		rejected += env.at(b) == 1 && env.at(d) == 1 ? 0 : 1;
+		return env.at(b) == 1 && env.at(d) == 1;
+	});
+	solver.addConstraint(2, {c, d}, [d, &rejected](const typecheck::BackjumpSolver::Assignment& env) {
+		rejected += env.at(d) == 0 ? 0 : 1;
+		return env.at(d) == 0;
+	});
+
+	typecheck::CountingObserver counts;
+	REQUIRE(solver.search(counts) == typecheck::BackjumpSolver::Unsatisfiable);
+	CHECK(solver.stats().nogoods > 0);
+
+	// Values turned down by a nogood are reported on top of those the constraints rejected themselves.
+	CHECK(counts.failures > rejected);
+	CHECK(counts.failuresByConstraint.count(1) + counts.failuresByConstraint.count(2) == 2);
+}
@@ -7,6 +7,14 @@
 #include "test_include_catch.hpp"
 #include "utils.hpp"
 
+#include <typecheck/debug_log.hpp>
+#include <typecheck/trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
 TEST_CASE("create function hash no args", "[type_manager]") {
     typecheck::TypeManager tm;
     CHECK(tm.CreateFunctionHash("foo", {}) != 0);
@@ -70,3 +78,669 @@ TEST_CASE("load basic type conversions", "[type_manager]") {
     CHECK(!tm.isConvertible("float", "int"));
     CHECK(!tm.isConvertible("double", "float"));
 }
+
+TEST_CASE("shared registry types and conversions", "[type_manager]") {
+    typecheck::TypeRegistry builder;
+    CHECK(builder.registerType("int"));
+    CHECK(builder.registerType("float"));
+    CHECK(!builder.registerType("float"));
+    CHECK(builder.setConvertible("int", "float"));
+    const auto registry = std::make_shared<const typecheck::TypeRegistry>(std::move(builder));
+
+    typecheck::TypeManager tm1(registry);
+    typecheck::TypeManager tm2(registry);
+    CHECK(tm1.hasRegisteredType("int"));
+    CHECK(!tm1.registerType("int"));
+    CHECK(tm1.isConvertible("int", "float"));
+    CHECK(!tm1.setConvertible("int", "float"));
+
+    // Local additions stay local
+    CHECK(tm1.registerType("double"));
+    CHECK(tm1.setConvertible("float", "double"));
+    CHECK(tm1.hasRegisteredType("double"));
+    CHECK(!tm2.hasRegisteredType("double"));
+    CHECK(!tm2.isConvertible("float", "double"));
+    CHECK(!registry->hasRegisteredType(tm1.getRegisteredType("double")));
+}
+
+TEST_CASE("shared registry function overloads", "[type_manager]") {
+    typecheck::TypeRegistry builder;
+    builder.registerType("int");
+    builder.registerType("float");
+    builder.registerType("double");
+    const auto fooHash = std::hash<std::string>()("foo:a");
+    builder.addFunction(fooHash, { builder.getRegisteredType(typecheck::RawType("int")) }, builder.getRegisteredType(typecheck::RawType("double")));
+    const auto registry = std::make_shared<const typecheck::TypeRegistry>(std::move(builder));
+
+    std::vector<std::thread> threads;
+    std::vector<int> solved(4, 0);
+    for (std::size_t i = 0; i < solved.size(); ++i) {
+        threads.emplace_back([&registry, &solved, fooHash, i] {
+            typecheck::TypeManager tm(registry);
+            const auto T = CreateMultipleSymbols(tm, 3);
+            tm.CreateBindFunctionConstraint(fooHash, T.at(0), { T.at(1) }, T.at(2));
+
+            const auto solution = tm.solve();
+            solved.at(i) = solution.has_value() &&
+                solution->getResolvedType(T.at(1)).raw().name() == "int" &&
+                solution->getResolvedType(T.at(2)).raw().name() == "double";
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& s : solved) {
+        CHECK(s == 1);
+    }
+}
+
+TEST_CASE("batch solve keeps order", "[type_manager]") {
+    std::vector<std::unique_ptr<typecheck::TypeManager>> managers;
+    std::vector<typecheck::TypeManager*> batch;
+    std::vector<typecheck::TypeVar> vars;
+    const std::vector<std::string> names{"int", "float", "double", "bool", "int", "float"};
+    for (const auto& name : names) {
+        auto tm = std::make_unique<typecheck::TypeManager>();
+        tm->registerType("int");
+        tm->registerType("float");
+        tm->registerType("double");
+        tm->registerType("bool");
+        const auto T = CreateMultipleSymbols(*tm, 2);
+        tm->CreateEqualsConstraint(T.at(0), T.at(1));
+        tm->CreateBindToConstraint(T.at(1), tm->getRegisteredType(typecheck::RawType(name)));
+        vars.push_back(T.at(0));
+        batch.push_back(tm.get());
+        managers.emplace_back(std::move(tm));
+    }
+
+    // Unsolvable, its result should not be mixed up with the others.
+    auto failing = std::make_unique<typecheck::TypeManager>();
+    failing->registerType("int");
+    failing->registerType("float");
+    const auto F = CreateMultipleSymbols(*failing, 1);
+    failing->CreateBindToConstraint(F.at(0), failing->getRegisteredType(typecheck::RawType("int")));
+    failing->CreateBindToConstraint(F.at(0), failing->getRegisteredType(typecheck::RawType("float")));
+    batch.insert(batch.begin() + 2, failing.get());
+
+    typecheck::BatchSolver solver(2);
+    CHECK(solver.concurrency() == 2);
+
+    const auto results = solver.solve(batch);
+    REQUIRE(results.size() == batch.size());
+    CHECK_FALSE(results.at(2).solution.has_value());
+    CHECK_FALSE(results.at(2).stats.solved);
+
+    for (std::size_t i = 0, n = 0; i < results.size(); ++i) {
+        if (i == 2) {
+            continue;
+        }
+        const auto& result = results.at(i);
+        REQUIRE(result.solution.has_value());
+        CHECK(result.stats.solved);
+        CHECK(result.stats.constraints == 2);
+        CHECK(result.worker < solver.concurrency());
+        CHECK(result.solution->getResolvedType(vars.at(n)).raw().name() == names.at(n));
+        ++n;
+    }
+
+    // The pool is reused between batches.
+    CHECK(solver.solve({}).empty());
+    CHECK(solver.solve({batch.front()}).at(0).solution.has_value());
+}
+
+TEST_CASE("reset reuses the manager", "[type_manager]") {
+    typecheck::TypeManager tm;
+    tm.registerType("int");
+    tm.registerType("float");
+    tm.setConvertible("int", "float");
+
+    const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+    for (std::size_t i = 0; i < 2; ++i) {
+        const auto T = CreateMultipleSymbols(tm, 3);
+        tm.CreateApplicableFunctionConstraint(fooHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+        tm.CreateBindFunctionConstraint(fooHash, T.at(0), { T.at(1) }, T.at(2));
+        CHECK(tm.solve().has_value());
+        CHECK(tm.getStats().solved);
+
+        const auto capacity = tm.constraints.capacity();
+        tm.reset(true);
+        CHECK(tm.constraints.empty());
+        CHECK(tm.constraints.capacity() == capacity);
+        CHECK_FALSE(tm.getStats().solved);
+
+        // Same symbols as a new manager, and the types are still there.
+        CHECK(tm.CreateTypeVar().symbol() == "T0");
+        CHECK(tm.hasRegisteredType("int"));
+        CHECK(tm.isConvertible("int", "float"));
+        tm.reset(true);
+    }
+
+    tm.reset();
+    CHECK_FALSE(tm.hasRegisteredType("int"));
+    CHECK_FALSE(tm.isConvertible("int", "float"));
+}
+
+TEST_CASE("reset forgets the last solution", "[type_manager]") {
+    getDefaultTypeManager(tm);
+    typecheck::SolveOptions options;
+    options.warmStart = true;
+
+    // Leaves a warm start of T0 = double behind.
+    const auto first = CreateMultipleSymbols(tm, 2);
+    tm.CreateBindToConstraint(first.at(0), tm.getRegisteredType("double"));
+    tm.CreateEqualsConstraint(first.at(0), first.at(1));
+    REQUIRE(tm.solve(options).has_value());
+
+    // Same symbols, but nothing to do with the last system, so solved the same as by a new manager.
+    tm.reset(true);
+    const auto T = CreateMultipleSymbols(tm, 2);
+    tm.CreateEqualsConstraint(T.at(0), T.at(1));
+
+    getDefaultTypeManager(fresh);
+    const auto F = CreateMultipleSymbols(fresh, 2);
+    fresh.CreateEqualsConstraint(F.at(0), F.at(1));
+
+    const auto solution = tm.solve(options);
+    const auto expected = fresh.solve(options);
+    REQUIRE(solution.has_value());
+    REQUIRE(expected.has_value());
+    CHECK(solution->getResolvedType(T.at(0)) == expected->getResolvedType(F.at(0)));
+    CHECK(solution->getResolvedType(T.at(1)) == expected->getResolvedType(F.at(1)));
+}
+
+namespace {
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        std::size_t allocations = 0;
+        std::size_t outstanding = 0;
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++this->allocations;
+            this->outstanding += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            this->outstanding -= bytes;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+}
+
+TEST_CASE("solve scratch memory comes from upstream resource", "[type_manager]") {
+    CountingResource upstream;
+    {
+        typecheck::TypeManager tm(typecheck::TypeRegistry::empty(), &upstream);
+        tm.registerType("int");
+        tm.registerType("float");
+        const auto T = CreateMultipleSymbols(tm, 2);
+        tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+        tm.CreateEqualsConstraint(T.at(0), T.at(1));
+
+        CHECK(tm.solve().has_value());
+        const auto allocations = upstream.allocations;
+        CHECK(allocations > 0);
+
+        // The blocks released after the first solve are reused by the second.
+        CHECK(tm.solve().has_value());
+        CHECK(upstream.allocations == allocations);
+    }
+    CHECK(upstream.outstanding == 0);
+}
+
+TEST_CASE("register types in bulk", "[type_manager]") {
+    typecheck::TypeRegistry builder;
+    builder.registerType("int");
+    const auto registry = std::make_shared<const typecheck::TypeRegistry>(std::move(builder));
+
+    typecheck::TypeManager tm(registry);
+    CHECK(tm.registerTypes(std::vector<std::string>{"int", "float", "double", "float"}) == 2);
+    CHECK(tm.hasRegisteredType("int"));
+    CHECK(tm.hasRegisteredType("float"));
+    CHECK(tm.hasRegisteredType("double"));
+    CHECK_FALSE(tm.hasRegisteredType("bool"));
+
+    typecheck::FunctionDefinition func;
+    func.set_name("foo");
+    func.add_args()->CopyFrom(tm.getRegisteredType("int"));
+    func.mutable_returntype()->CopyFrom(tm.getRegisteredType("float"));
+    const typecheck::Type funcType(func);
+    CHECK(tm.registerTypes(std::vector<typecheck::Type>{funcType, funcType}) == 1);
+    CHECK(tm.hasRegisteredType(funcType));
+
+    // Different return type, so a different function type.
+    func.mutable_returntype()->CopyFrom(tm.getRegisteredType("double"));
+    CHECK_FALSE(tm.hasRegisteredType(typecheck::Type(func)));
+}
+
+TEST_CASE("registry snapshot round trip", "[type_manager]") {
+    typecheck::TypeRegistry builder;
+    builder.registerTypes(std::vector<std::string>{"int", "float", "double"});
+    builder.setConvertible("int", "float");
+    builder.setConvertible("int", "double");
+    builder.setConvertible("float", "double");
+    const auto fooHash = std::hash<std::string>()("foo:a");
+    builder.addFunction(fooHash, { builder.getRegisteredType(typecheck::RawType("int")) }, builder.getRegisteredType(typecheck::RawType("double")));
+
+    const auto path = std::string("typecheck_snapshot_test.bin");
+    REQUIRE(builder.save(path));
+    auto loaded = typecheck::TypeRegistry::load(path);
+    std::remove(path.c_str());
+    REQUIRE(loaded.has_value());
+    CHECK(loaded->serialize() == builder.serialize());
+    CHECK(loaded->hasRegisteredType(typecheck::RawType("float")));
+    CHECK(loaded->hasConversion("int", "double"));
+    CHECK_FALSE(loaded->hasConversion("double", "int"));
+
+    // New overloads don't reuse the symbols from the snapshot.
+    loaded->addFunction(fooHash, { loaded->getRegisteredType(typecheck::RawType("float")) }, loaded->getRegisteredType(typecheck::RawType("float")));
+    CHECK(loaded->functions().size() == 2);
+    CHECK(loaded->functions().at(1).returnvar().symbol() != loaded->functions().at(0).returnvar().symbol());
+
+    typecheck::TypeManager tm(std::make_shared<const typecheck::TypeRegistry>(std::move(*loaded)));
+    const auto T = CreateMultipleSymbols(tm, 3);
+    tm.CreateBindFunctionConstraint(fooHash, T.at(0), { T.at(1) }, T.at(2));
+    tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("double"));
+    const auto solution = tm.solve();
+    REQUIRE(solution.has_value());
+    CHECK(solution->getResolvedType(T.at(1)).raw().name() == "int");
+
+    CHECK_FALSE(typecheck::TypeRegistry::unserialize("not a snapshot").has_value());
+    const auto snapshot = builder.serialize();
+    CHECK_FALSE(typecheck::TypeRegistry::unserialize(std::string_view(snapshot).substr(0, snapshot.size() - 1)).has_value());
+    CHECK_FALSE(typecheck::TypeRegistry::load("does_not_exist.bin").has_value());
+}
+
+TEST_CASE("fork shares the base environment", "[type_manager]") {
+    typecheck::TypeManager base;
+    base.registerType("int");
+    base.registerType("float");
+    base.registerType("double");
+    base.setConvertible("int", "double");
+    const auto T = CreateMultipleSymbols(base, 2);
+    base.CreateConvertibleConstraint(T.at(0), T.at(1));
+    const auto baseBind = base.CreateBindToConstraint(T.at(0), base.getRegisteredType("int"));
+
+    auto child = base.fork();
+    auto sibling = base.fork();
+    CHECK(base.constraints.empty());
+    CHECK(child->hasRegisteredType("int"));
+    CHECK(child->isConvertible("int", "double"));
+
+    // Only the child sees what it adds.
+    child->registerType("bool");
+    child->CreateBindToConstraint(T.at(1), child->getRegisteredType("double"));
+    const auto C = child->CreateTypeVar();
+    child->CreateEqualsConstraint(C, T.at(1));
+    CHECK_FALSE(base.hasRegisteredType("bool"));
+    CHECK_FALSE(sibling->hasRegisteredType("bool"));
+
+    // What the parent froze isn't added again.
+    CHECK(child->registerTypes(std::vector<std::string>{"int", "float", "char"}) == 1);
+    CHECK(child->registerTypes({child->getRegisteredType("double"), child->getRegisteredType("char")}) == 0);
+    CHECK_FALSE(child->setConvertible("int", "double"));
+    CHECK(child->setConvertible("char", "int"));
+    CHECK_FALSE(base.hasRegisteredType("char"));
+    CHECK_FALSE(base.isConvertible("char", "int"));
+
+    sibling->CreateBindToConstraint(T.at(1), sibling->getRegisteredType("float"));
+
+    const auto childSolution = child->solve();
+    REQUIRE(childSolution.has_value());
+    CHECK(child->getStats().constraints == 4);
+    CHECK(childSolution->getResolvedType(T.at(0)).raw().name() == "int");
+    CHECK(childSolution->getResolvedType(C).raw().name() == "double");
+
+    // int isn't convertible to float.
+    CHECK_FALSE(sibling->solve().has_value());
+
+    const auto baseSolution = base.solve();
+    REQUIRE(baseSolution.has_value());
+    CHECK(base.getStats().constraints == 2);
+
+    // Forks of forks keep every layer.
+    auto grandchild = child->fork();
+    CHECK(grandchild->hasRegisteredType("bool"));
+    CHECK(grandchild->getConstraint(baseBind) != nullptr);
+    REQUIRE(grandchild->solve().has_value());
+    CHECK(grandchild->getStats().constraints == 4);
+
+    grandchild->reset(true);
+    CHECK(grandchild->hasRegisteredType("bool"));
+    CHECK(grandchild->isConvertible("int", "double"));
+}
+
+TEST_CASE("constraint graph export", "[type_manager]") {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 4);
+
+    const auto literal = tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByFloat);
+    tm.CreateEqualsConstraint(T.at(0), T.at(1));
+    tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("int"));
+    tm.CreateConvertibleConstraint(T.at(2), T.at(3));
+
+    tm.setDetailedStats(true);
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    REQUIRE(tm.solve(options).has_value());
+    CHECK(tm.getStats().evaluations.at(literal) > 0);
+
+    const auto graph = tm.getConstraintGraph();
+    REQUIRE(graph.variables().size() == 4);
+    REQUIRE(graph.constraints().size() == 4);
+    CHECK(graph.components() == 2);
+
+    CHECK(graph.variables().at(0).symbol == T.at(0).symbol());
+    CHECK(graph.variables().at(0).domain == 2);
+    CHECK(graph.variables().at(0).degree == 2);
+    CHECK(graph.variables().at(2).domain == 1);
+    CHECK(graph.variables().at(0).component != graph.variables().at(2).component);
+    CHECK(graph.variables().at(2).component == graph.variables().at(3).component);
+    for (const auto& node : graph.constraints()) {
+        REQUIRE(node.evaluations.has_value());
+        CHECK(*node.evaluations == tm.getStats().evaluations.at(node.id));
+    }
+
+    const auto dot = graph.to_dot();
+    CHECK(dot.rfind("graph constraints {", 0) == 0);
+    CHECK(dot.find("ConformsTo #" + std::to_string(literal)) != std::string::npos);
+
+    const auto json = graph.to_json();
+    CHECK(json.find("\"components\":2") != std::string::npos);
+    CHECK(json.find("\"kind\":\"Conversion\"") != std::string::npos);
+}
+
+TEST_CASE("constraint graph joins calls through their definitions", "[type_manager]") {
+    getDefaultTypeManager(tm);
+    const auto fooHash = tm.CreateFunctionHash("foo", {"a"});
+    tm.CreateApplicableFunctionConstraint(fooHash, {tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+    tm.CreateApplicableFunctionConstraint(fooHash, {tm.getRegisteredType("int"), tm.getRegisteredType("int")}, tm.getRegisteredType("float"));
+
+    // Two calls that share no variable, but both bind to the one overload with a single arg.
+    const auto T = CreateMultipleSymbols(tm, 6);
+    tm.CreateBindFunctionConstraint(fooHash, T.at(0), {T.at(1)}, T.at(2));
+    tm.CreateBindFunctionConstraint(fooHash, T.at(3), {T.at(4)}, T.at(5));
+
+    const auto graph = tm.getConstraintGraph();
+    const auto find = [&graph](const typecheck::TypeVar& var) {
+        const auto& variables = graph.variables();
+        return *std::find_if(variables.begin(), variables.end(), [&var](const typecheck::ConstraintGraph::Variable& v) {
+            return v.symbol == var.symbol();
+        });
+    };
+    CHECK(find(T.at(0)).domain == 1);
+    CHECK(find(T.at(1)).component == find(T.at(4)).component);
+    for (const auto& node : graph.constraints()) {
+        if (node.kind == typecheck::BindOverload) {
+            // The call's type, return and arg, then the return and arg of the definition.
+            CHECK(node.variables.size() == 5);
+        }
+    }
+}
+
+#ifdef TYPECHECK_ENABLE_PROFILER
+TEST_CASE("constraint profile", "[type_manager]") {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 3);
+
+    const auto literal = tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateEqualsConstraint(T.at(0), T.at(1));
+    tm.CreateConvertibleConstraint(T.at(1), T.at(2));
+
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    REQUIRE(tm.solve(options).has_value());
+    const auto& profile = tm.getProfile();
+    CHECK(profile.size() == 3);
+
+    const auto top = profile.top(2);
+    REQUIRE(top.size() == 2);
+    CHECK(top.at(0).time >= top.at(1).time);
+    for (const auto& entry : profile.top(3)) {
+        CHECK(entry.evaluations > 0);
+        CHECK(entry.failures <= entry.evaluations);
+    }
+    CHECK(profile.ShortDebugString(3).find("constraint " + std::to_string(literal) + ":") != std::string::npos);
+
+    // Starts over with each solve.
+    tm.reset(true);
+    REQUIRE(tm.solve().has_value());
+    CHECK(tm.getProfile().size() == 0);
+}
+#endif
+
+TEST_CASE("trace log flush", "[type_manager]") {
+    // Starts from an empty log.
+    std::ostringstream discard;
+    typecheck::TraceLog::flush(discard);
+
+    const auto now = typecheck::TraceLog::Clock::now();
+    typecheck::TraceLog::record("first", now, now + std::chrono::microseconds(3));
+    std::thread([] {
+        typecheck::TraceSpan span("second");
+    }).join();
+
+    std::ostringstream out;
+    typecheck::TraceLog::flush(out);
+    const auto json = out.str();
+    CHECK(json.rfind("{\"traceEvents\":[", 0) == 0);
+    CHECK(json.find("\"name\":\"first\"") != std::string::npos);
+    CHECK(json.find("\"dur\":3.000") != std::string::npos);
+    CHECK(json.find("\"name\":\"second\"") != std::string::npos);
+    CHECK(typecheck::TraceLog::dropped() == 0);
+
+    std::ostringstream again;
+    typecheck::TraceLog::flush(again);
+    CHECK(again.str() == "{\"traceEvents\":[],\"displayTimeUnit\":\"ns\"}");
+}
+
+TEST_CASE("trace totals record one span per kind", "[type_manager]") {
+    std::ostringstream discard;
+    typecheck::TraceLog::flush(discard);
+    const auto dropped = typecheck::TraceLog::dropped();
+
+    // Far more steps than the buffer holds.
+    {
+        typecheck::TraceSpan phase("phase");
+        typecheck::TraceTotals<3> totals;
+        for (std::size_t i = 0; i < 100000; ++i) {
+            typecheck::TraceTotals<3>::Step step(totals, i % 2, i % 2 == 0 ? "even" : "odd");
+        }
+    }
+
+    std::ostringstream out;
+    typecheck::TraceLog::flush(out);
+    const auto json = out.str();
+    const auto count = [&json](const std::string& name) {
+        std::size_t n = 0;
+        for (auto at = json.find(name); at != std::string::npos; at = json.find(name, at + 1)) {
+            ++n;
+        }
+        return n;
+    };
+    CHECK(count("\"name\":\"even\"") == 1);
+    CHECK(count("\"name\":\"odd\"") == 1);
+    CHECK(count("\"name\":\"phase\"") == 1);
+    CHECK(typecheck::TraceLog::dropped() == dropped);
+}
+
+#ifdef TYPECHECK_ENABLE_TRACING
+TEST_CASE("solve records trace spans", "[type_manager]") {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 2);
+    tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateConvertibleConstraint(T.at(0), T.at(1));
+
+    std::ostringstream discard;
+    typecheck::TraceLog::flush(discard);
+
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    REQUIRE(tm.solve(options).has_value());
+
+    std::ostringstream out;
+    typecheck::TraceLog::flush(out);
+    const auto json = out.str();
+    for (const auto* name : {"solve", "simplify", "build domains", "gather ConformsTo", "gather Conversion", "heuristic setup", "search", "reconstruct types"}) {
+        CHECK(json.find("\"name\":\"" + std::string(name) + "\"") != std::string::npos);
+    }
+}
+
+TEST_CASE("solve records one gather span per constraint kind", "[type_manager]") {
+    getDefaultTypeManager(tm);
+
+    // However many constraints, the spans recorded stay the same, so the phases are never crowded out of the buffer.
+    const auto T = CreateMultipleSymbols(tm, 200);
+    for (const auto& var : T) {
+        tm.CreateBindToConstraint(var, tm.getRegisteredType("int"));
+    }
+
+    std::ostringstream discard;
+    typecheck::TraceLog::flush(discard);
+
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    REQUIRE(tm.solve(options).has_value());
+
+    std::ostringstream out;
+    typecheck::TraceLog::flush(out);
+    const auto json = out.str();
+    const auto count = [&json](const std::string& name) {
+        std::size_t n = 0;
+        for (auto at = json.find("\"name\":\"" + name + "\""); at != std::string::npos; at = json.find("\"name\":\"" + name + "\"", at + 1)) {
+            ++n;
+        }
+        return n;
+    };
+    CHECK(count("gather Bind") == 1);
+    for (const auto* name : {"solve", "gather constraints", "heuristic setup", "search", "reconstruct types"}) {
+        CHECK(count(name) == 1);
+    }
+}
+#endif
+
+TEST_CASE("solve reports the search to an observer", "[type_manager]") {
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 4);
+    tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByFloat);
+    tm.CreateEqualsConstraint(T.at(0), T.at(1));
+    tm.CreateBindToConstraint(T.at(2), tm.getRegisteredType("int"));
+    tm.CreateConvertibleConstraint(T.at(2), T.at(3));
+
+    typecheck::SolveOptions options;
+    options.fastPaths = false;
+    typecheck::CountingObserver counts;
+    const auto observed = tm.solve(options, counts);
+    REQUIRE(observed.has_value());
+    CHECK(counts.expansions > 0);
+    CHECK(counts.expansions >= counts.failures);
+
+    const auto plain = tm.solve(options);
+    REQUIRE(plain.has_value());
+    CHECK(observed->getResolvedTypes() == plain->getResolvedTypes());
+
+    // The fast path doesn't search at all.
+    options.fastPaths = true;
+    typecheck::CountingObserver none;
+    REQUIRE(tm.solve(options, none).has_value());
+    CHECK(tm.getStats().path == typecheck::SolveStats::Lattice);
+    CHECK(none.expansions == 0);
+}
+
+TEST_CASE("debug log decode", "[type_manager]") {
+    std::ostringstream discard;
+    typecheck::DebugLog::flush(discard);
+
+    getDefaultTypeManager(tm);
+    const auto T = CreateMultipleSymbols(tm, 2);
+    typecheck::Constraint constraint;
+    constraint.set_kind(typecheck::ConstraintKind::Conversion);
+    constraint.set_id(7);
+    constraint.mutable_types()->mutable_first()->CopyFrom(T.at(0));
+    constraint.mutable_types()->mutable_second()->CopyFrom(T.at(1));
+    std::thread([&constraint] {
+        typecheck::DebugLog::record(typecheck::DebugLog::Event::MalformedConstraint, constraint);
+    }).join();
+
+    // Asking for a type that was never resolved is logged rather than printed.
+    CHECK_FALSE(typecheck::ConstraintPass().getResolvedType(T.at(1)).has_raw());
+
+    std::stringstream log;
+    typecheck::DebugLog::flush(log);
+    std::ostringstream text;
+    REQUIRE(typecheck::DebugLog::decode(log, text));
+    const auto decoded = text.str();
+    CHECK(decoded.find("warning: malformed Conversion 7 " + T.at(0).symbol() + " " + T.at(1).symbol() + "\n") != std::string::npos);
+    CHECK(decoded.find("error: unresolved type " + T.at(1).symbol() + "\n") != std::string::npos);
+    CHECK(typecheck::DebugLog::varIndex("T12") == 12);
+    CHECK(typecheck::DebugLog::varIndex("T") == typecheck::DebugLog::NONE);
+
+    std::istringstream notALog("{\"traceEvents\":[]}");
+    CHECK_FALSE(typecheck::DebugLog::decode(notALog, text));
+}
+
+TEST_CASE("debug log frees the buffers of exited threads", "[type_manager]") {
+    std::ostringstream discard;
+    typecheck::DebugLog::flush(discard);
+    const auto buffers = typecheck::DebugLog::buffers();
+    const auto dropped = typecheck::DebugLog::dropped();
+
+    for (int i = 0; i < 32; ++i) {
+        std::thread([] {
+            typecheck::DebugLog::record(typecheck::DebugLog::Event::UnresolvedType, "T1");
+        }).join();
+    }
+    CHECK(typecheck::DebugLog::buffers() == buffers + 32);
+
+    // Records from exited threads are still written before their buffers go.
+    std::stringstream log;
+    typecheck::DebugLog::flush(log);
+    std::ostringstream text;
+    REQUIRE(typecheck::DebugLog::decode(log, text));
+    const auto decoded = text.str();
+    CHECK(std::count(decoded.begin(), decoded.end(), '\n') == 32);
+    CHECK(typecheck::DebugLog::buffers() == buffers);
+    CHECK(typecheck::DebugLog::dropped() == dropped);
+}
+
+TEST_CASE("memory usage", "[type_manager]") {
+    getDefaultTypeManager(tm);
+    const auto empty = tm.memoryUsage();
+    CHECK(empty.registry > 0);
+    CHECK(empty.constraints == 0);
+    CHECK(empty.functions == 0);
+
+    const auto T = CreateMultipleSymbols(tm, 100);
+    for (std::size_t i = 0; i + 1 < T.size(); ++i) {
+        tm.CreateConvertibleConstraint(T.at(i), T.at(i + 1));
+    }
+    tm.CreateLiteralConformsToConstraint(T.at(0), typecheck::KnownProtocolKind::ExpressibleByInteger);
+    tm.CreateApplicableFunctionConstraint(1, std::vector<typecheck::TypeVar>{T.at(1)}, T.at(2));
+
+    const auto built = tm.memoryUsage();
+    CHECK(built.constraints >= 100 * sizeof(typecheck::Constraint));
+    CHECK(built.typeVars > 100 * sizeof(std::string));
+    CHECK(built.functions > 0);
+    CHECK(built.registry == empty.registry);
+
+    typecheck::SolveOptions options;
+    options.warmStart = true;
+    REQUIRE(tm.solve(options).has_value());
+    const auto solved = tm.memoryUsage();
+    CHECK(solved.solverWorkspace > empty.solverWorkspace);
+    CHECK(solved.result > empty.result);
+    CHECK(solved.total() == solved.registry + solved.constraints + solved.typeVars + solved.functions + solved.solverWorkspace + solved.result);
+
+    // Frozen state is shared with the child, so moves out of the parent's own totals.
+    const auto child = tm.fork();
+    const auto forked = tm.memoryUsage();
+    CHECK(forked.constraints == 0);
+    CHECK(forked.shared >= built.constraints);
+    CHECK(child->memoryUsage().shared == forked.shared);
+}
@@ -31,6 +31,24 @@ auto CreateMultipleSymbols(typecheck::TypeManager& tm, const std::size_t& num) -
     return out;
 }
 
+// A ring of equal variables, some bound to `int` and some integer literals.
+void CreateStressSystem(typecheck::TypeManager& tm, const std::size_t numSymbols) {
+    tm.registerType("bool");
+    tm.registerType("void");
+
+    const auto T = CreateMultipleSymbols(tm, numSymbols);
+    const auto intType = tm.getRegisteredType("int");
+    for (std::size_t i = 0; i < numSymbols; ++i) {
+        if (i % (numSymbols / 5) == 0) {
+            tm.CreateBindToConstraint(T.at(i), intType);
+        } else if (i % (numSymbols / 3) == 0) {
+            tm.CreateLiteralConformsToConstraint(T.at(i), typecheck::KnownProtocolKind::ExpressibleByInteger);
+        }
+
+        tm.CreateEqualsConstraint(T.at(i), T.at((i + 1) % numSymbols));
+    }
+}
+
 #define getDefaultTypeManager(tm) \
 typecheck::TypeManager tm; \
 setupTypeManager(&tm)
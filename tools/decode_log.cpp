@@ -0,0 +1,23 @@
+// Prints a binary `typecheck::DebugLog`, written by `DebugLog::flush`, as text.
+// Usage: typecheck_decode_log <file>, or reads stdin without a file.
+#include <typecheck/debug_log.hpp>
+
+#include <fstream>
+#include <iostream>
+
+auto main(int argc, char* argv[]) -> int {
+	std::ifstream file;
+	if (argc > 1) {
+		file.open(argv[1], std::ios::binary);
+		if (!file) {
+			std::cerr << "Cannot open " << argv[1] << std::endl;
+			return 1;
+		}
+	}
+
+	if (!typecheck::DebugLog::decode(argc > 1 ? file : std::cin, std::cout)) {
+		std::cerr << "Not a typecheck debug log, or truncated" << std::endl;
+		return 1;
+	}
+	return 0;
+}